@@ -0,0 +1,398 @@
+//
+//  chebyshev_polynomials.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <ATen/ATen.h>
+#include <torch/csrc/api/include/torch/nn/functional.h>
+#include "chebyshev_polynomials.hpp"
+#include "precision_policy.hpp"
+
+ChebyshevPolynomial::ChebyshevPolynomial(torch::Tensor in_coefficients, double in_lower, double in_upper, bool in_requires_grad):
+    coefficient_tensor(precision_policy::cast(in_coefficients)),
+    lower_bound(in_lower),
+    upper_bound(in_upper),
+    requires_grad(in_requires_grad){
+        TORCH_CHECK(in_upper > in_lower, "ChebyshevPolynomial: empty segment [", in_lower, ", ", in_upper, "]");
+        coefficient_tensor.set_requires_grad(requires_grad);
+}
+
+ChebyshevPolynomial::ChebyshevPolynomial(double in_coefficient, double in_lower, double in_upper, bool in_requires_grad):
+    ChebyshevPolynomial(in_coefficient * torch::ones(1, precision_policy::options()), in_lower, in_upper, in_requires_grad){}
+
+torch::Tensor ChebyshevPolynomial::coefficients() const {
+    return coefficient_tensor;
+}
+
+size_t ChebyshevPolynomial::degree() const {
+    return coefficient_tensor.size(0) - 1;
+}
+
+double ChebyshevPolynomial::lower() const {
+    return lower_bound;
+}
+
+double ChebyshevPolynomial::upper() const {
+    return upper_bound;
+}
+
+bool ChebyshevPolynomial::get_requires_grad() const {
+    return requires_grad;
+}
+
+torch::Tensor ChebyshevPolynomial::operator[](const int index) const {
+    return coefficient_tensor[index];
+}
+
+ChebyshevPolynomial ChebyshevPolynomial::clone() const {
+    return ChebyshevPolynomial(coefficient_tensor.clone(), lower_bound, upper_bound, requires_grad);
+}
+
+void ChebyshevPolynomial::_check_same_segment(const ChebyshevPolynomial& other) const {
+    TORCH_CHECK(
+        lower_bound == other.lower_bound && upper_bound == other.upper_bound,
+        "ChebyshevPolynomial: operands on different segments [", lower_bound, ", ", upper_bound, "] and [",
+        other.lower_bound, ", ", other.upper_bound, "]"
+    );
+}
+
+torch::Tensor ChebyshevPolynomial::_to_local(const torch::Tensor t) const {
+    return (2 * t - (lower_bound + upper_bound)) / (upper_bound - lower_bound);
+}
+
+namespace F = torch::nn::functional;
+
+ChebyshevPolynomial ChebyshevPolynomial::operator+(const ChebyshevPolynomial& other) const {
+    _check_same_segment(other);
+    const int this_degree = degree();
+    const int other_degree = other.degree();
+    const int new_degree = std::max(this_degree, other_degree);
+
+    torch::Tensor this_padded_coefs = F::pad(coefficient_tensor, F::PadFuncOptions({0, new_degree - this_degree}));
+    torch::Tensor other_padded_coefs = F::pad(other.coefficient_tensor, F::PadFuncOptions({0, new_degree - other_degree}));
+    return ChebyshevPolynomial(this_padded_coefs + other_padded_coefs, lower_bound, upper_bound, requires_grad || other.requires_grad);
+}
+
+ChebyshevPolynomial ChebyshevPolynomial::operator+(const double other) const {
+    return operator+(ChebyshevPolynomial(other, lower_bound, upper_bound, false));
+}
+
+ChebyshevPolynomial ChebyshevPolynomial::operator-(const ChebyshevPolynomial& other) const {
+    return operator+(other * static_cast<double>(-1));
+}
+
+ChebyshevPolynomial ChebyshevPolynomial::operator-(const double other) const {
+    return operator+(-other);
+}
+
+/**
+ * @brief Basis-native product, using \f$ T_m T_n = (T_{m+n} + T_{|m-n|}) / 2 \f$
+ */
+ChebyshevPolynomial ChebyshevPolynomial::operator*(const ChebyshevPolynomial& other) const {
+    _check_same_segment(other);
+    const int this_degree = degree();
+    const int other_degree = other.degree();
+    const int new_degree = this_degree + other_degree;
+    std::vector<torch::Tensor> new_coefficients(
+        new_degree + 1,
+        torch::zeros({}, torch::TensorOptions().dtype(precision_policy::promote(coefficient_tensor, other.coefficient_tensor)))
+    );
+
+    for (int i = 0; i <= this_degree; ++i){
+        for (int j = 0; j <= other_degree; ++j){
+            torch::Tensor half_product = 0.5 * coefficient_tensor[i] * other.coefficient_tensor[j];
+            new_coefficients[i + j] = new_coefficients[i + j] + half_product;
+            new_coefficients[std::abs(i - j)] = new_coefficients[std::abs(i - j)] + half_product;
+        }
+    }
+    return ChebyshevPolynomial(
+        torch::stack(torch::TensorList(new_coefficients)),
+        lower_bound,
+        upper_bound,
+        requires_grad || other.requires_grad
+    );
+}
+
+ChebyshevPolynomial ChebyshevPolynomial::operator*(const double other) const {
+    return ChebyshevPolynomial(coefficient_tensor * other, lower_bound, upper_bound, requires_grad);
+}
+
+/**
+ * @brief Clenshaw evaluation \f$ b_k = c_k + 2u b_{k+1} - b_{k+2} \f$, \f$ f = c_0 + u b_1 - b_2 \f$, elementwise in t.
+ */
+torch::Tensor ChebyshevPolynomial::operator()(const torch::Tensor t) const {
+    const torch::Dtype eval_dtype = precision_policy::promote(precision_policy::cast(t), coefficient_tensor);
+    torch::Tensor u = _to_local(t.to(eval_dtype));
+    torch::Tensor coefs = coefficient_tensor.to(eval_dtype);
+    torch::Tensor b_1 = torch::zeros_like(u);
+    torch::Tensor b_2 = torch::zeros_like(u);
+    for (int k = degree(); k >= 1; --k){
+        torch::Tensor b_0 = coefs[k] + 2 * u * b_1 - b_2;
+        b_2 = b_1;
+        b_1 = b_0;
+    }
+    return coefs[0] + u * b_1 - b_2;
+}
+
+torch::Tensor ChebyshevPolynomial::operator()(const double t) const {
+    torch::Tensor torch_t = torch::scalar_tensor(t, coefficient_tensor.options());
+    return ChebyshevPolynomial::operator()(torch_t);
+}
+
+/**
+ * @brief Basis-native derivative, \f$ d_k = d_{k+2} + 2(k+1) c_{k+1} \f$ with \f$ d_0 \f$ halved, rescaled to x.
+ */
+ChebyshevPolynomial ChebyshevPolynomial::derivative() const {
+    const int n = degree();
+    if (n == 0){
+        return ChebyshevPolynomial(torch::zeros(1, coefficient_tensor.options()), lower_bound, upper_bound, requires_grad);
+    }
+    std::vector<torch::Tensor> new_coefficients(n + 2, torch::zeros({}, coefficient_tensor.options()));
+    for (int k = n - 1; k >= 0; --k){
+        new_coefficients[k] = new_coefficients[k + 2] + 2 * (k + 1) * coefficient_tensor[k + 1];
+    }
+    new_coefficients[0] = new_coefficients[0] / 2;
+    new_coefficients.resize(n);
+    const double scale = 2 / (upper_bound - lower_bound);
+    return ChebyshevPolynomial(torch::stack(torch::TensorList(new_coefficients)) * scale, lower_bound, upper_bound, requires_grad);
+}
+
+/**
+ * @brief Basis-native antiderivative, \f$ C_k = (c_{k-1} - c_{k+1}) / 2k \f$ (with \f$ 2c_0 \f$ in place of \f$ c_0 \f$).
+ *
+ * The integration constant is chosen so that the antiderivative vanishes at the lower end of the segment, where
+ * TorchPolynomial::antiderivative() vanishes at 0: the two differ by a constant unless the segment starts at 0.
+ */
+ChebyshevPolynomial ChebyshevPolynomial::antiderivative() const {
+    const int n = degree();
+    const torch::Tensor zero = torch::zeros({}, coefficient_tensor.options());
+    auto c = [&](int k){ return (k <= n) ? coefficient_tensor[k] : zero; };
+
+    std::vector<torch::Tensor> new_coefficients({zero});
+    torch::Tensor value_at_lower = zero;
+    for (int k = 1; k <= n + 1; ++k){
+        torch::Tensor previous = (k == 1) ? 2 * c(0) : c(k - 1);
+        torch::Tensor new_coefficient = (previous - c(k + 1)) / (2.0 * k);
+        new_coefficients.push_back(new_coefficient);
+        // T_k(-1) = (-1)^k
+        value_at_lower = (k % 2 == 0) ? value_at_lower + new_coefficient : value_at_lower - new_coefficient;
+    }
+    new_coefficients[0] = -value_at_lower;
+    const double scale = (upper_bound - lower_bound) / 2;
+    return ChebyshevPolynomial(torch::stack(torch::TensorList(new_coefficients)) * scale, lower_bound, upper_bound, requires_grad);
+}
+
+/**
+ * @brief Computes \f$ g(x) = f(ax + b) \f$ on the preimage of the segment.
+ *
+ * The local coordinate of the new segment is u(ax + b) itself when a > 0 and its opposite when a < 0, so the only
+ * work is to move the bounds, and to flip the sign of the odd coefficients when the map reverses orientation.
+ */
+ChebyshevPolynomial ChebyshevPolynomial::compose_affine(const double a, const double b) const {
+    TORCH_CHECK(a != 0, "ChebyshevPolynomial: compose_affine needs a != 0");
+    const double new_lower = (((a > 0) ? lower_bound : upper_bound) - b) / a;
+    const double new_upper = (((a > 0) ? upper_bound : lower_bound) - b) / a;
+    if (a > 0){
+        return ChebyshevPolynomial(coefficient_tensor, new_lower, new_upper, requires_grad);
+    }
+    std::vector<double> signs;
+    for (int k = 0; k <= degree(); ++k){
+        signs.push_back((k % 2 == 0) ? 1 : -1);
+    }
+    torch::Tensor sign_tensor = torch::tensor(signs, coefficient_tensor.options());
+    return ChebyshevPolynomial(coefficient_tensor * sign_tensor, new_lower, new_upper, requires_grad);
+}
+
+/**
+ * @brief Exact conversion from monomial form, by Horner's scheme on \f$ x = \frac{b-a}{2} T_1 + \frac{a+b}{2} T_0 \f$
+ */
+ChebyshevPolynomial ChebyshevPolynomial::from_monomial(const TorchPolynomial& in_polynomial, double in_lower, double in_upper){
+    const int n = in_polynomial.degree();
+    torch::Tensor monomial_coefs = in_polynomial.coefficients();
+    torch::Tensor x_coefs = torch::zeros(2, monomial_coefs.options());
+    x_coefs[0] += (in_lower + in_upper) / 2;
+    x_coefs[1] += (in_upper - in_lower) / 2;
+    ChebyshevPolynomial x_chebyshev(x_coefs, in_lower, in_upper, false);
+
+    const bool requires_grad = in_polynomial.get_requires_grad();
+    ChebyshevPolynomial result(monomial_coefs[n].reshape(1), in_lower, in_upper, requires_grad);
+    for (int k = n - 1; k >= 0; --k){
+        result = result * x_chebyshev + ChebyshevPolynomial(monomial_coefs[k].reshape(1), in_lower, in_upper, requires_grad);
+    }
+    return result;
+}
+
+/**
+ * @brief Exact conversion to monomial form, summing \f$ c_k T_k(u(x)) \f$ with \f$ T_{k+1} = 2uT_k - T_{k-1} \f$
+ */
+TorchPolynomial ChebyshevPolynomial::to_monomial() const {
+    const int n = degree();
+    const double width = upper_bound - lower_bound;
+    torch::Tensor u_coefs = torch::zeros(2, coefficient_tensor.options());
+    u_coefs[0] += -(lower_bound + upper_bound) / width;
+    u_coefs[1] += 2 / width;
+    TorchPolynomial u_monomial(u_coefs, false);
+
+    TorchPolynomial t_previous(1.0, false);
+    TorchPolynomial t_current = u_monomial;
+    TorchPolynomial result = TorchPolynomial(coefficient_tensor[0].reshape(1), requires_grad);
+    for (int k = 1; k <= n; ++k){
+        result = result + TorchPolynomial(coefficient_tensor[k].reshape(1), requires_grad) * t_current;
+        TorchPolynomial t_next = u_monomial * t_current * 2.0 - t_previous;
+        t_previous = t_current;
+        t_current = t_next;
+    }
+    return result;
+}
+
+ChebyshevSegmentFunction::ChebyshevSegmentFunction(torch::Tensor in_exp_coefs, std::vector<ChebyshevPolynomial> in_polynomials):
+    exp_coefs(precision_policy::cast(in_exp_coefs)),
+    polynomials(in_polynomials){
+        TORCH_CHECK(
+            exp_coefs.size(0) == polynomials.size(),
+            "ChebyshevSegmentFunction: ", exp_coefs.size(0), " exp coefficients for ", polynomials.size(), " polynomials"
+        );
+}
+
+ChebyshevSegmentFunction ChebyshevSegmentFunction::from_segment_function(const SegmentFunction& in_function, double in_lower, double in_upper){
+    std::vector<ChebyshevPolynomial> new_polynomials;
+    std::vector<TorchPolynomial> monomials = in_function.get_polynomials();
+    for (int i = 0; i < monomials.size(); ++i){
+        new_polynomials.push_back(ChebyshevPolynomial::from_monomial(monomials[i], in_lower, in_upper));
+    }
+    return ChebyshevSegmentFunction(in_function.get_exp_coefs(), new_polynomials);
+}
+
+SegmentFunction ChebyshevSegmentFunction::to_segment_function() const {
+    std::vector<TorchPolynomial> monomials;
+    for (int i = 0; i < polynomials.size(); ++i){
+        monomials.push_back(polynomials[i].to_monomial());
+    }
+    return SegmentFunction(exp_coefs, monomials);
+}
+
+torch::Tensor ChebyshevSegmentFunction::get_exp_coefs() const {
+    return exp_coefs;
+}
+
+std::vector<ChebyshevPolynomial> ChebyshevSegmentFunction::get_polynomials() const {
+    return polynomials;
+}
+
+ChebyshevSegmentFunction ChebyshevSegmentFunction::operator+(const ChebyshevSegmentFunction& other) const {
+    torch::Tensor to_cat[2] = {exp_coefs, other.exp_coefs};
+    std::vector<ChebyshevPolynomial> new_polynomials;
+    new_polynomials.insert(new_polynomials.end(), polynomials.begin(), polynomials.end());
+    new_polynomials.insert(new_polynomials.end(), other.polynomials.begin(), other.polynomials.end());
+    return ChebyshevSegmentFunction(torch::cat(to_cat), new_polynomials);
+}
+
+ChebyshevSegmentFunction ChebyshevSegmentFunction::operator*(const ChebyshevSegmentFunction& other) const {
+    std::vector<ChebyshevPolynomial> new_polynomials;
+    std::vector<torch::Tensor> new_exp_coefs;
+    for (int i = 0; i < polynomials.size(); ++i){
+        for (int j = 0; j < other.polynomials.size(); ++j){
+            new_polynomials.push_back(polynomials[i] * other.polynomials[j]);
+            new_exp_coefs.push_back(exp_coefs[i] + other.exp_coefs[j]);
+        }
+    }
+    return ChebyshevSegmentFunction(torch::stack(new_exp_coefs), new_polynomials);
+}
+
+torch::Tensor ChebyshevSegmentFunction::operator()(const torch::Tensor t) const {
+    const torch::Dtype eval_dtype = precision_policy::promote(precision_policy::cast(t), exp_coefs);
+    torch::Tensor cast_t = t.to(eval_dtype);
+    torch::Tensor result = torch::zeros_like(cast_t);
+    for (int i = 0; i < polynomials.size(); ++i){
+        result = result + torch::exp(exp_coefs[i].to(eval_dtype) * cast_t) * polynomials[i](cast_t);
+    }
+    return result;
+}
+
+torch::Tensor ChebyshevSegmentFunction::operator()(const double t) const {
+    torch::Tensor torch_t = torch::scalar_tensor(t, exp_coefs.options());
+    return ChebyshevSegmentFunction::operator()(torch_t);
+}
+
+/**
+ * @brief \f$ (e^{cx} P)' = e^{cx} (P' + cP) \f$, term by term.
+ */
+ChebyshevSegmentFunction ChebyshevSegmentFunction::derivative() const {
+    std::vector<ChebyshevPolynomial> new_polynomials;
+    for (int i = 0; i < polynomials.size(); ++i){
+        const ChebyshevPolynomial& polynomial_i = polynomials[i];
+        ChebyshevPolynomial exp_coef_i(exp_coefs[i].reshape(1), polynomial_i.lower(), polynomial_i.upper(), false);
+        new_polynomials.push_back(polynomial_i.derivative() + exp_coef_i * polynomial_i);
+    }
+    return ChebyshevSegmentFunction(exp_coefs.clone(), new_polynomials);
+}
+
+/**
+ * @brief Finds Q with \f$ Q' + cQ = P \f$, so that \f$ e^{cx} Q \f$ is an antiderivative of \f$ e^{cx} P \f$
+ *
+ * In the Chebyshev basis the derivative only maps \f$ T_j \f$ onto lower order terms, so \f$ (D + c) \f$ is upper
+ * triangular and Q is obtained by back substitution from the highest coefficient down.
+ */
+ChebyshevPolynomial ChebyshevSegmentFunction::_single_antiderivative(const ChebyshevPolynomial& in_polynomial, const torch::Tensor in_exp_coef) const {
+    if (in_exp_coef.item<double>() == 0){
+        return in_polynomial.antiderivative();
+    }
+    const int n = in_polynomial.degree();
+    const double scale = 2 / (in_polynomial.upper() - in_polynomial.lower());
+    std::vector<torch::Tensor> new_coefficients(n + 1);
+    for (int k = n; k >= 0; --k){
+        torch::Tensor derivative_k = torch::zeros({}, in_polynomial.coefficients().options());
+        for (int j = k + 1; j <= n; j += 2){
+            derivative_k = derivative_k + j * new_coefficients[j];
+        }
+        derivative_k = derivative_k * ((k == 0) ? scale : 2 * scale);
+        new_coefficients[k] = (in_polynomial[k] - derivative_k) / in_exp_coef;
+    }
+    return ChebyshevPolynomial(
+        torch::stack(torch::TensorList(new_coefficients)),
+        in_polynomial.lower(),
+        in_polynomial.upper(),
+        in_polynomial.get_requires_grad()
+    );
+}
+
+/**
+ * @brief Term by term antiderivative. Terms with \f$ c \ne 0 \f$ match SegmentFunction::antiderivative() exactly,
+ * terms with \f$ c = 0 \f$ vanish at the lower end of the segment rather than at 0, see ChebyshevPolynomial::antiderivative().
+ */
+ChebyshevSegmentFunction ChebyshevSegmentFunction::antiderivative() const {
+    std::vector<ChebyshevPolynomial> new_polynomials;
+    for (int i = 0; i < polynomials.size(); ++i){
+        new_polynomials.push_back(_single_antiderivative(polynomials[i], exp_coefs[i]));
+    }
+    return ChebyshevSegmentFunction(exp_coefs.clone(), new_polynomials);
+}
+
+/**
+ * @brief \f$ e^{c(ax + b)} P(ax + b) = e^{(ca) x} \left( e^{cb} P(ax + b) \right) \f$, term by term.
+ */
+ChebyshevSegmentFunction ChebyshevSegmentFunction::compose_affine(const double a, const double b) const {
+    std::vector<ChebyshevPolynomial> new_polynomials;
+    for (int i = 0; i < polynomials.size(); ++i){
+        ChebyshevPolynomial composed_polynomial = polynomials[i].compose_affine(a, b);
+        new_polynomials.push_back(ChebyshevPolynomial(
+            composed_polynomial.coefficients() * torch::exp(exp_coefs[i] * b),
+            composed_polynomial.lower(),
+            composed_polynomial.upper(),
+            composed_polynomial.get_requires_grad()
+        ));
+    }
+    return ChebyshevSegmentFunction(exp_coefs * a, new_polynomials);
+}
+
+size_t ChebyshevSegmentFunction::degree() const {
+    size_t greatest_degree = 0;
+    for (int i = 0; i < polynomials.size(); ++i){
+        if (polynomials[i].degree() > greatest_degree){
+            greatest_degree = polynomials[i].degree();
+        }
+    }
+    return greatest_degree;
+}
@@ -0,0 +1,109 @@
+//
+//  chebyshev_polynomials.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef chebyshev_polynomials_hpp
+#define chebyshev_polynomials_hpp
+
+#include <stdio.h>
+#include <torch/script.h>
+
+#include "torch_polynomials.hpp"
+#include "segment_functions.hpp"
+
+/**
+ * @brief libtorch - compatible representation of \f$ f(x) = \sum_{k=0}^n c_k T_k(u(x)) \f$ on a segment \f$ [a, b] \f$
+ *
+ * \f$ T_k \f$ is the k-th Chebyshev polynomial of the first kind and \f$ u(x) = (2x - a - b) / (b - a) \f$ maps the
+ * segment onto \f$ [-1, 1] \f$. Unlike the monomial coefficients of TorchPolynomial, the \f$ c_k \f$ stay of the same
+ * order of magnitude as the function on the segment however far the segment is from 0, so long-dated segments are
+ * well conditioned. Evaluation uses the Clenshaw recurrence, batched over the evaluation points.
+ *
+ * Binary operations require both operands to live on the same segment. antiderivative() vanishes at the lower end
+ * of the segment, not at 0 as TorchPolynomial::antiderivative() does.
+ */
+class ChebyshevPolynomial{
+
+    public:
+
+        ChebyshevPolynomial(torch::Tensor in_coefficients, double in_lower, double in_upper, bool in_requires_grad=true);
+        ChebyshevPolynomial(double in_coefficient, double in_lower, double in_upper, bool in_requires_grad=true);
+
+        static ChebyshevPolynomial from_monomial(const TorchPolynomial& in_polynomial, double in_lower, double in_upper);
+        TorchPolynomial to_monomial() const;
+
+        ChebyshevPolynomial operator+(const ChebyshevPolynomial& other) const;
+        ChebyshevPolynomial operator+(const double other) const;
+        ChebyshevPolynomial operator-(const ChebyshevPolynomial& other) const;
+        ChebyshevPolynomial operator-(const double other) const;
+        ChebyshevPolynomial operator*(const ChebyshevPolynomial& other) const;
+        ChebyshevPolynomial operator*(const double other) const;
+
+        torch::Tensor operator()(const torch::Tensor t) const;
+        torch::Tensor operator()(const double t) const;
+
+        torch::Tensor operator[](int index) const;
+
+        torch::Tensor coefficients() const;
+        size_t degree() const;
+        double lower() const;
+        double upper() const;
+        bool get_requires_grad() const;
+
+        ChebyshevPolynomial derivative() const;
+        ChebyshevPolynomial antiderivative() const;
+        ChebyshevPolynomial compose_affine(const double a, const double b) const;
+        ChebyshevPolynomial clone() const;
+
+    private:
+        torch::Tensor coefficient_tensor;
+        double lower_bound;
+        double upper_bound;
+        bool requires_grad;
+
+        torch::Tensor _to_local(const torch::Tensor t) const;
+        void _check_same_segment(const ChebyshevPolynomial& other) const;
+};
+
+/**
+ * @brief \f$ f(x) = \sum_i e^{c_i x} P_i(x) \f$ with every \f$ P_i \f$ a ChebyshevPolynomial on the same segment.
+ *
+ * Mirrors SegmentFunction, to which it converts exactly in both directions. The one convention which differs is the
+ * integration constant of antiderivative() on terms with a zero exp coefficient, fixed at the lower end of the
+ * segment here and at 0 in SegmentFunction.
+ */
+class ChebyshevSegmentFunction{
+
+    public:
+
+        ChebyshevSegmentFunction(torch::Tensor in_exp_coefs, std::vector<ChebyshevPolynomial> in_polynomials);
+
+        static ChebyshevSegmentFunction from_segment_function(const SegmentFunction& in_function, double in_lower, double in_upper);
+        SegmentFunction to_segment_function() const;
+
+        torch::Tensor get_exp_coefs() const;
+        std::vector<ChebyshevPolynomial> get_polynomials() const;
+
+        ChebyshevSegmentFunction operator+(const ChebyshevSegmentFunction& other) const;
+        ChebyshevSegmentFunction operator*(const ChebyshevSegmentFunction& other) const;
+
+        torch::Tensor operator()(const torch::Tensor t) const;
+        torch::Tensor operator()(const double t) const;
+
+        ChebyshevSegmentFunction derivative() const;
+        ChebyshevSegmentFunction antiderivative() const;
+        ChebyshevSegmentFunction compose_affine(const double a, const double b) const;
+
+        size_t degree() const;
+
+    private:
+        torch::Tensor exp_coefs;
+        std::vector<ChebyshevPolynomial> polynomials;
+
+        ChebyshevPolynomial _single_antiderivative(const ChebyshevPolynomial& in_polynomial, const torch::Tensor in_exp_coef) const;
+};
+
+#endif /* chebyshev_polynomials_hpp */
@@ -0,0 +1,109 @@
+//
+//  chebyshev_polynomials_tests.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <iostream>
+#include <string>
+#include "chebyshev_polynomials.hpp"
+#include "chebyshev_polynomials_tests.hpp"
+
+namespace {
+    const double lower = 30;
+    const double upper = 40;
+
+    torch::Tensor test_points(){
+        return torch::linspace(lower, upper, 11, torch::kFloat64);
+    }
+
+    bool all_close(torch::Tensor a, torch::Tensor b, double tolerance){
+        return torch::allclose(a.to(torch::kFloat64), b.to(torch::kFloat64), tolerance, tolerance);
+    }
+}
+
+int chebyshev_polynomials_tests::test_conversion(){
+    std::vector<double> coefs = {0.5, -0.25, 0.125, 0.0625};
+    ChebyshevPolynomial chebyshev(torch::tensor(coefs), lower, upper);
+    TorchPolynomial monomial = chebyshev.to_monomial();
+    ChebyshevPolynomial round_trip = ChebyshevPolynomial::from_monomial(monomial, lower, upper);
+
+    bool values_match = all_close(chebyshev(test_points()), monomial(test_points()), 1e-8);
+    bool round_trip_matches = all_close(chebyshev.coefficients(), round_trip.coefficients(), 1e-8);
+    bool is_correct = values_match && round_trip_matches;
+    std::string output_message = is_correct ? "Conversion passed" : "Conversion FAILED";
+    std::cout << output_message << "\n";
+    if (not is_correct){
+        std::cout << "Round trip coefficients: " << round_trip.coefficients() << "\n";
+    }
+    return (int) not is_correct;
+}
+
+int chebyshev_polynomials_tests::test_calculus(){
+    std::vector<double> coefs = {1, 2, 3, 4};
+    ChebyshevPolynomial chebyshev(torch::tensor(coefs), lower, upper);
+    TorchPolynomial monomial = chebyshev.to_monomial();
+
+    bool derivative_matches = all_close(chebyshev.derivative()(test_points()), monomial.derivative()(test_points()), 1e-8);
+    bool antiderivative_inverts = all_close(chebyshev.antiderivative().derivative().coefficients(), chebyshev.coefficients(), 1e-10);
+    bool antiderivative_vanishes = (std::abs(chebyshev.antiderivative()(lower).item<double>()) < 1e-10);
+    bool is_correct = derivative_matches && antiderivative_inverts && antiderivative_vanishes;
+    std::string output_message = is_correct ? "Derivative and antiderivative passed" : "Derivative and antiderivative FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
+
+int chebyshev_polynomials_tests::test_multiplication(){
+    std::vector<double> a_coefs = {1, -1, 0.5};
+    std::vector<double> b_coefs = {0.25, 2, -1, 3};
+    ChebyshevPolynomial a_chebyshev(torch::tensor(a_coefs), lower, upper);
+    ChebyshevPolynomial b_chebyshev(torch::tensor(b_coefs), lower, upper);
+    ChebyshevPolynomial product = a_chebyshev * b_chebyshev;
+
+    bool is_correct = (product.degree() == 5)
+        && all_close(product(test_points()), a_chebyshev(test_points()) * b_chebyshev(test_points()), 1e-10);
+    std::string output_message = is_correct ? "Multiplication passed" : "Multiplication FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
+
+int chebyshev_polynomials_tests::test_segment_antiderivative(){
+    std::vector<double> exp_coefs = {-0.03, 0};
+    std::vector<double> p_coefs = {1, 0.5, -0.2};
+    std::vector<double> q_coefs = {0.1, 0.3};
+    std::vector<ChebyshevPolynomial> polynomials{
+        ChebyshevPolynomial(torch::tensor(p_coefs), lower, upper),
+        ChebyshevPolynomial(torch::tensor(q_coefs), lower, upper)
+    };
+    ChebyshevSegmentFunction segment(torch::tensor(exp_coefs), polynomials);
+
+    ChebyshevSegmentFunction round_trip = segment.antiderivative().derivative();
+    bool antiderivative_inverts = all_close(round_trip(test_points()), segment(test_points()), 1e-8);
+    bool conversion_matches = all_close(segment.to_segment_function()(test_points()), segment(test_points()), 1e-8);
+    // the c == 0 term is integrated from the lower end of the segment here and from 0 in SegmentFunction
+    torch::Tensor convention_gap = segment.antiderivative().to_segment_function()(test_points())
+        - segment.to_segment_function().antiderivative()(test_points());
+    bool gap_is_constant = all_close(convention_gap, convention_gap[0] * torch::ones_like(convention_gap), 1e-8);
+    bool is_correct = antiderivative_inverts && conversion_matches && gap_is_constant;
+    std::string output_message = is_correct ? "Segment antiderivative passed" : "Segment antiderivative FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
+
+
+int chebyshev_polynomials_tests::test_compose_affine(){
+    std::vector<double> exp_coefs = {-0.03};
+    std::vector<double> p_coefs = {1, 0.5, -0.2, 0.1};
+    std::vector<ChebyshevPolynomial> polynomials{ChebyshevPolynomial(torch::tensor(p_coefs), lower, upper)};
+    ChebyshevSegmentFunction segment(torch::tensor(exp_coefs), polynomials);
+
+    // x -> 40 - x maps [0, 10] onto the segment reversed
+    ChebyshevSegmentFunction reflected = segment.compose_affine(-1, upper);
+    torch::Tensor local_points = torch::linspace(0, upper - lower, 11, torch::kFloat64);
+    bool is_correct = (reflected.get_polynomials()[0].lower() == 0) && (reflected.get_polynomials()[0].upper() == upper - lower)
+        && all_close(reflected(local_points), segment(upper - local_points), 1e-10);
+    std::string output_message = is_correct ? "Affine composition passed" : "Affine composition FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+//
+//  chebyshev_polynomials_tests.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef chebyshev_polynomials_tests_hpp
+#define chebyshev_polynomials_tests_hpp
+
+#include <iostream>
+#include <string>
+
+namespace chebyshev_polynomials_tests {
+    int test_conversion();
+    int test_calculus();
+    int test_multiplication();
+    int test_segment_antiderivative();
+    int test_compose_affine();
+}
+
+#endif /* chebyshev_polynomials_tests_hpp */
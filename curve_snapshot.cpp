@@ -0,0 +1,110 @@
+//
+//  curve_snapshot.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <thread>
+#include "curve_snapshot.hpp"
+
+CurveSnapshot::CurveSnapshot(const SegmentFunction& in_curve, uint64_t in_version):
+    curve_function(in_curve.detach()),
+    version_number(in_version){}
+
+const SegmentFunction& CurveSnapshot::curve() const {
+    return curve_function;
+}
+
+/**
+ * @brief Pointer to the snapshot's curve which also keeps the snapshot alive, e.g. to hand to PricingService::submit.
+ */
+std::shared_ptr<const SegmentFunction> CurveSnapshot::shared_curve() const {
+    return std::shared_ptr<const SegmentFunction>(shared_from_this(), &curve_function);
+}
+
+uint64_t CurveSnapshot::version() const {
+    return version_number;
+}
+
+torch::Tensor CurveSnapshot::operator()(const torch::Tensor t) const {
+    torch::NoGradGuard no_grad;
+    return curve_function(t);
+}
+
+torch::Tensor CurveSnapshot::operator()(const double t) const {
+    torch::NoGradGuard no_grad;
+    return curve_function(t);
+}
+
+CurvePublisher::CurvePublisher(const SegmentFunction& in_initial_curve):
+    current_sequence(0),
+    latest_version(0){
+        slots[0].snapshot = std::make_shared<const CurveSnapshot>(in_initial_curve, 0);
+}
+
+/**
+ * @brief Returns the current snapshot without taking any lock.
+ *
+ * A publisher only rewrites a slot which is not current and has no registered reader. A reader which registers
+ * on a slot and then still sees it current can therefore copy its shared_ptr safely. All accesses are sequentially
+ * consistent so that the reader's registration and the publisher's check cannot pass each other.
+ */
+std::shared_ptr<const CurveSnapshot> CurvePublisher::acquire() const {
+    while (true){
+        const uint64_t sequence = current_sequence.load();
+        const Slot& slot = slots[sequence % n_slots];
+        slot.n_readers.fetch_add(1);
+        if (current_sequence.load() == sequence){
+            std::shared_ptr<const CurveSnapshot> snapshot = slot.snapshot;
+            slot.n_readers.fetch_sub(1);
+            return snapshot;
+        }
+        slot.n_readers.fetch_sub(1);
+    }
+}
+
+/**
+ * @brief Publishes a detached copy of in_curve and returns the version which is current once the call completes.
+ *
+ * Concurrent publishers are allowed: versions are handed out in call order and the published version never
+ * goes backwards. A slower publisher holding an older version does not replace a newer snapshot: its copy is
+ * discarded and the newer, current version is returned instead, so the result is always a version readers can see.
+ */
+uint64_t CurvePublisher::publish(const SegmentFunction& in_curve){
+    const uint64_t new_version = latest_version.fetch_add(1) + 1;
+    std::shared_ptr<const CurveSnapshot> snapshot;
+    {
+        torch::NoGradGuard no_grad;
+        snapshot = std::make_shared<const CurveSnapshot>(in_curve, new_version);
+    }
+    std::shared_ptr<const CurveSnapshot> superseded;
+    {
+        std::lock_guard<std::mutex> lock(publish_mutex);
+        const uint64_t sequence = current_sequence.load();
+        Slot& current_slot = slots[sequence % n_slots];
+        if (current_slot.snapshot->version() > new_version){
+            return current_slot.snapshot->version();
+        }
+        // only readers which saw the sequence move can be registered here, and they leave without copying
+        Slot& next_slot = slots[(sequence + 1) % n_slots];
+        while (next_slot.n_readers.load() != 0){
+            std::this_thread::yield();
+        }
+        next_slot.snapshot = snapshot;
+        current_sequence.store(sequence + 1);
+
+        // a reader registered on the previous slot before the store may still be copying its shared_ptr, later
+        // ones see the new sequence and retry
+        while (current_slot.n_readers.load() != 0){
+            std::this_thread::yield();
+        }
+        // released outside the lock, so that freeing an old curve never delays the next publisher
+        superseded = std::move(current_slot.snapshot);
+    }
+    return new_version;
+}
+
+uint64_t CurvePublisher::version() const {
+    return acquire()->version();
+}
@@ -0,0 +1,80 @@
+//
+//  curve_snapshot.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef curve_snapshot_hpp
+#define curve_snapshot_hpp
+
+#include <stdio.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <torch/script.h>
+
+#include "segment_functions.hpp"
+
+/**
+ * @brief Immutable, detached copy of a curve at a given version.
+ *
+ * The SegmentFunction held here shares no tensor storage and no autograd graph with the curve being calibrated,
+ * so any number of pricing threads can evaluate it while the calibrator keeps updating its own tensors in place.
+ */
+class CurveSnapshot : public std::enable_shared_from_this<CurveSnapshot> {
+
+    public:
+        CurveSnapshot(const SegmentFunction& in_curve, uint64_t in_version);
+
+        const SegmentFunction& curve() const;
+        std::shared_ptr<const SegmentFunction> shared_curve() const;
+        uint64_t version() const;
+
+        torch::Tensor operator()(const torch::Tensor t) const;
+        torch::Tensor operator()(const double t) const;
+
+    private:
+        const SegmentFunction curve_function;
+        const uint64_t version_number;
+};
+
+/**
+ * @brief RCU-style publication point for a live curve.
+ *
+ * Readers call acquire() and keep the returned snapshot for a whole pricing batch; it stays valid and unchanged
+ * however many versions are published in the meantime. A superseded snapshot is freed when the last reader
+ * holding it lets go: the publisher itself only keeps the current snapshot.
+ *
+ * The current snapshot lives in one of two slots, picked by a publication sequence number. acquire() is lock-free:
+ * it registers on the current slot with an atomic counter, checks the sequence has not moved, and copies the
+ * shared_ptr out. It only retries if a publication lands in between. publish() builds the detached copy first,
+ * then, under a mutex that only publishers take, fills the other slot and advances the sequence. It then waits for
+ * readers still registered on the previous slot to leave (they hold it for the length of a shared_ptr copy) and
+ * drops the publisher's reference to the superseded snapshot.
+ */
+class CurvePublisher {
+
+    public:
+        CurvePublisher(const SegmentFunction& in_initial_curve);
+
+        std::shared_ptr<const CurveSnapshot> acquire() const;
+        uint64_t publish(const SegmentFunction& in_curve);
+        uint64_t version() const;
+
+    private:
+        static const int n_slots = 2;
+
+        struct Slot {
+            std::shared_ptr<const CurveSnapshot> snapshot;
+            mutable std::atomic<int64_t> n_readers{0};
+        };
+
+        std::array<Slot, n_slots> slots;
+        std::atomic<uint64_t> current_sequence;
+        std::atomic<uint64_t> latest_version;
+        std::mutex publish_mutex;
+};
+
+#endif /* curve_snapshot_hpp */
@@ -0,0 +1,84 @@
+//
+//  curve_snapshot_tests.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include "curve_snapshot.hpp"
+#include "curve_snapshot_tests.hpp"
+
+namespace {
+    SegmentFunction build_flat_curve(double rate){
+        std::vector<double> exp_coefs = {-rate};
+        std::vector<TorchPolynomial> polynomials{TorchPolynomial(1.0)};
+        return SegmentFunction(torch::tensor(exp_coefs), polynomials);
+    }
+}
+
+int curve_snapshot_tests::test_isolation(){
+    SegmentFunction live_curve = build_flat_curve(0.01);
+    CurvePublisher publisher(live_curve);
+    std::shared_ptr<const CurveSnapshot> old_snapshot = publisher.acquire();
+
+    // the calibrator updates its own tensors in place, the published snapshot must not see it
+    {
+        torch::NoGradGuard no_grad;
+        live_curve.get_exp_coefs().fill_(-0.02);
+    }
+    bool is_isolated = (std::abs(old_snapshot->operator()(1.0).item<double>() - std::exp(-0.01)) < 1e-12);
+
+    uint64_t new_version = publisher.publish(live_curve);
+    std::shared_ptr<const CurveSnapshot> new_snapshot = publisher.acquire();
+    bool is_published = (new_version == 1) && (new_snapshot->version() == 1)
+        && (std::abs(new_snapshot->operator()(1.0).item<double>() - std::exp(-0.02)) < 1e-12);
+    bool old_is_kept = (old_snapshot->version() == 0)
+        && (std::abs(old_snapshot->operator()(1.0).item<double>() - std::exp(-0.01)) < 1e-12);
+
+    // the publisher drops its reference to a superseded snapshot, the last reader frees it
+    std::weak_ptr<const CurveSnapshot> weak_old_snapshot = old_snapshot;
+    old_snapshot.reset();
+    bool old_is_freed = weak_old_snapshot.expired();
+
+    bool is_correct = is_isolated && is_published && old_is_kept && old_is_freed;
+    std::string output_message = is_correct ? "Snapshot isolation passed" : "Snapshot isolation FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
+
+int curve_snapshot_tests::test_concurrent_readers(){
+    CurvePublisher publisher(build_flat_curve(0.01));
+    std::atomic<bool> done(false);
+    std::atomic<int> n_inconsistent(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i){
+        readers.emplace_back([&publisher, &done, &n_inconsistent](){
+            while (not done.load()){
+                std::shared_ptr<const CurveSnapshot> snapshot = publisher.acquire();
+                // every version v is published with rate 0.01 * (v + 1)
+                double rate = 0.01 * (snapshot->version() + 1);
+                double first = snapshot->operator()(1.0).item<double>();
+                double second = snapshot->operator()(1.0).item<double>();
+                if (first != second || std::abs(first - std::exp(-rate)) > 1e-12){
+                    n_inconsistent++;
+                }
+            }
+        });
+    }
+    for (int v = 1; v <= 50; ++v){
+        publisher.publish(build_flat_curve(0.01 * (v + 1)));
+    }
+    done.store(true);
+    for (std::thread& reader : readers){
+        reader.join();
+    }
+
+    bool is_correct = (n_inconsistent.load() == 0) && (publisher.version() == 50);
+    std::string output_message = is_correct ? "Concurrent readers passed" : "Concurrent readers FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
@@ -0,0 +1,19 @@
+//
+//  curve_snapshot_tests.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef curve_snapshot_tests_hpp
+#define curve_snapshot_tests_hpp
+
+#include <iostream>
+#include <string>
+
+namespace curve_snapshot_tests {
+    int test_isolation();
+    int test_concurrent_readers();
+}
+
+#endif /* curve_snapshot_tests_hpp */
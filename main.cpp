@@ -8,14 +8,28 @@
 #include <stdio.h>
 #include "torch_polynomials_tests.hpp"
 #include "segment_function_tests.hpp"
+#include "chebyshev_polynomials_tests.hpp"
+#include "pricing_service_tests.hpp"
+#include "curve_snapshot_tests.hpp"
+#include "replay_tape_tests.hpp"
+#include "scenario_runner_tests.hpp"
 
 int main(int argc, const char * argv[]) {
     // insert code here...
     int num_errors = 0;
+    // ScenarioRunner forks its workers, so it runs before any other test has started libtorch's worker threads
+    std::cout << "Testing ScenarioRunner" << std::endl;
+    num_errors += scenario_runner_tests::test_sharded_run();
+    num_errors += scenario_runner_tests::test_padded_sensitivities();
+    num_errors += scenario_runner_tests::test_malformed_inputs();
+
+
     std::cout << "Testing TorchPolynomials" << std::endl;
     num_errors += torch_polynomials_tests::test_degree();
     num_errors += torch_polynomials_tests::test_addition();
     num_errors += torch_polynomials_tests::test_multiplication();
+    num_errors += torch_polynomials_tests::test_precision();
+    num_errors += torch_polynomials_tests::test_compose_affine();
 
 
     std::cout << "Testing SegmentFunction" << std::endl;
@@ -23,6 +37,35 @@ int main(int argc, const char * argv[]) {
     num_errors += segment_function_tests::test_addition();
     num_errors += segment_function_tests::test_subtraction();
     num_errors += segment_function_tests::test_derivative();
+    num_errors += segment_function_tests::test_evaluation();
+    num_errors += segment_function_tests::test_shift();
+    num_errors += segment_function_tests::test_independent_equal_rates();
+    num_errors += segment_function_tests::test_batched_evaluation();
+
+
+    std::cout << "Testing ChebyshevPolynomial" << std::endl;
+    num_errors += chebyshev_polynomials_tests::test_conversion();
+    num_errors += chebyshev_polynomials_tests::test_calculus();
+    num_errors += chebyshev_polynomials_tests::test_multiplication();
+    num_errors += chebyshev_polynomials_tests::test_segment_antiderivative();
+    num_errors += chebyshev_polynomials_tests::test_compose_affine();
+
+
+    std::cout << "Testing PricingService" << std::endl;
+    num_errors += pricing_service_tests::test_single_request();
+    num_errors += pricing_service_tests::test_coalescing();
+    num_errors += pricing_service_tests::test_malformed_request();
+
+
+    std::cout << "Testing CurveSnapshot" << std::endl;
+    num_errors += curve_snapshot_tests::test_isolation();
+    num_errors += curve_snapshot_tests::test_concurrent_readers();
+
+
+    std::cout << "Testing ReplayTape" << std::endl;
+    num_errors += replay_tape_tests::test_replay();
+    num_errors += replay_tape_tests::test_replay_derivative();
+
     std::cout << "Found " << num_errors << " errors" << std::endl;
     return 0;
 }  
@@ -0,0 +1,65 @@
+//
+//  precision_policy.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <atomic>
+#include "precision_policy.hpp"
+
+namespace {
+    std::atomic<precision_policy::Precision> global_precision(precision_policy::Precision::Float64);
+
+    // -1 means no override, otherwise the integer value of the overriding Precision
+    thread_local int thread_override = -1;
+}
+
+void precision_policy::set_precision(Precision in_precision){
+    global_precision.store(in_precision);
+}
+
+precision_policy::Precision precision_policy::get_precision(){
+    if (thread_override >= 0){
+        return static_cast<Precision>(thread_override);
+    }
+    return global_precision.load();
+}
+
+torch::Dtype precision_policy::to_dtype(Precision in_precision){
+    return (in_precision == Precision::Float32) ? torch::kFloat32 : torch::kFloat64;
+}
+
+torch::Dtype precision_policy::dtype(){
+    return to_dtype(get_precision());
+}
+
+torch::TensorOptions precision_policy::options(){
+    return torch::TensorOptions().dtype(dtype());
+}
+
+/**
+ * @brief Widens a tensor to the policy dtype: integral and narrower floating tensors are cast, wider ones are kept.
+ *
+ * The cast is differentiable, so a user-created leaf still receives its .grad() after a backward pass, and when no
+ * cast is needed the input itself is returned.
+ */
+torch::Tensor precision_policy::cast(const torch::Tensor& in_tensor){
+    if (not in_tensor.is_floating_point()){
+        return in_tensor.to(dtype());
+    }
+    return in_tensor.to(torch::promote_types(in_tensor.scalar_type(), dtype()));
+}
+
+torch::Dtype precision_policy::promote(const torch::Tensor& a, const torch::Tensor& b){
+    return torch::promote_types(a.scalar_type(), b.scalar_type());
+}
+
+precision_policy::PrecisionGuard::PrecisionGuard(Precision in_precision):
+    previous_override(thread_override){
+        thread_override = static_cast<int>(in_precision);
+}
+
+precision_policy::PrecisionGuard::~PrecisionGuard(){
+    thread_override = previous_override;
+}
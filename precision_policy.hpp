@@ -0,0 +1,66 @@
+//
+//  precision_policy.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef precision_policy_hpp
+#define precision_policy_hpp
+
+#include <stdio.h>
+#include <torch/script.h>
+
+/**
+ * @brief Library-wide floating point precision used when building TorchPolynomial and SegmentFunction tensors.
+ *
+ * Every tensor the library creates on its own (constants, padding, exponential coefficients, evaluation points)
+ * uses the dtype of the active policy. Tensors handed to the constructors of TorchPolynomial, SegmentFunction and
+ * the Chebyshev classes are only ever widened to it: integral and float32 inputs become float64 under the Float64
+ * policy, but float64 inputs stay float64 under Float32.
+ *
+ * Results of arithmetic, calculus, shift() or detach() are therefore stored in the wider of their operands' dtypes
+ * and the policy's: a float64 curve keeps its precision when it is shifted or combined on a Float32 thread, and
+ * evaluation is carried out in the wider of the points and the object's coefficients.
+ *
+ * The default is Float64, which is what calibration wants. Bulk scenario pricing can switch to Float32, either
+ * process-wide with set_precision() or for the current thread only with a PrecisionGuard, and gets float32 curves
+ * by building them from float32 (or integral) data under that policy.
+ */
+namespace precision_policy {
+
+    enum class Precision {
+        Float32,
+        Float64
+    };
+
+    void set_precision(Precision in_precision);
+    Precision get_precision();
+
+    torch::Dtype dtype();
+    torch::Dtype to_dtype(Precision in_precision);
+    torch::TensorOptions options();
+
+    torch::Tensor cast(const torch::Tensor& in_tensor);
+    torch::Dtype promote(const torch::Tensor& a, const torch::Tensor& b);
+
+    /**
+     * @brief RAII override of the precision for the current thread.
+     *
+     * The previous thread-local setting is restored on destruction, guards can be nested.
+     */
+    class PrecisionGuard {
+
+        public:
+            PrecisionGuard(Precision in_precision);
+            ~PrecisionGuard();
+
+            PrecisionGuard(const PrecisionGuard&) = delete;
+            PrecisionGuard& operator=(const PrecisionGuard&) = delete;
+
+        private:
+            int previous_override;
+    };
+}
+
+#endif /* precision_policy_hpp */
@@ -0,0 +1,250 @@
+//
+//  pricing_service.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <ATen/Parallel.h>
+#include <stdexcept>
+#include "pricing_service.hpp"
+
+/**
+ * @brief Starts the worker pool.
+ *
+ * libtorch only accepts an inter-op thread count once per process, before any inter-op work has started,
+ * so leave config.inter_op_threads at 0 unless this is the first service created.
+ */
+PricingService::PricingService(PricingServiceConfig in_config):
+    config(in_config),
+    stopping(false),
+    batch_count(0),
+    request_count(0){
+        if (config.inter_op_threads > 0){
+            at::set_num_interop_threads(config.inter_op_threads);
+        }
+        for (int i = 0; i < std::max(config.num_workers, 1); ++i){
+            workers.emplace_back(&PricingService::_worker_loop, this);
+        }
+}
+
+PricingService::~PricingService(){
+    shutdown();
+}
+
+std::future<torch::Tensor> PricingService::submit(
+    std::shared_ptr<const SegmentFunction> curve,
+    torch::Tensor cashflow_times,
+    torch::Tensor cashflow_amounts,
+    torch::Tensor instrument_index,
+    int64_t n_instruments,
+    Clock::time_point deadline
+){
+    PendingRequest request;
+    std::future<torch::Tensor> result = request.result.get_future();
+    std::string error = curve ? _validate(cashflow_times, cashflow_amounts, instrument_index, n_instruments) : "null curve";
+    if (not error.empty()){
+        // a malformed request only fails its own future, it never reaches a batch shared with others
+        request.result.set_exception(std::make_exception_ptr(std::invalid_argument("PricingService: " + error)));
+        return result;
+    }
+    request.curve = curve;
+    request.cashflow_times = cashflow_times.reshape(-1);
+    request.cashflow_amounts = cashflow_amounts.reshape(-1);
+    request.instrument_index = instrument_index.reshape(-1).to(torch::kLong);
+    request.n_instruments = n_instruments;
+    request.close_by = std::min(Clock::now() + config.max_batch_delay, deadline);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping){
+            request.result.set_exception(std::make_exception_ptr(std::runtime_error("PricingService is shut down")));
+            return result;
+        }
+        queue.push_back(std::move(request));
+    }
+    queue_cv.notify_one();
+    return result;
+}
+
+/**
+ * @brief Returns an empty string for a well-formed request, otherwise what is wrong with it.
+ *
+ * Requests are concatenated and their instrument indices offset within a batch, so a request whose sizes disagree
+ * or whose indices leave [0, n_instruments) would silently corrupt the PVs of its neighbours.
+ */
+std::string PricingService::_validate(
+    const torch::Tensor& cashflow_times,
+    const torch::Tensor& cashflow_amounts,
+    const torch::Tensor& instrument_index,
+    int64_t n_instruments
+){
+    if (not cashflow_times.defined() || not cashflow_amounts.defined() || not instrument_index.defined()){
+        return "undefined input tensor";
+    }
+    if (n_instruments < 0){
+        return "negative n_instruments";
+    }
+    const int64_t n_cashflows = cashflow_times.numel();
+    if (cashflow_amounts.numel() != n_cashflows || instrument_index.numel() != n_cashflows){
+        return "cashflow_times, cashflow_amounts and instrument_index must have the same number of elements";
+    }
+    if (n_cashflows == 0){
+        return "";
+    }
+    if (instrument_index.is_floating_point() || instrument_index.is_complex()){
+        return "instrument_index must be integral";
+    }
+    if (instrument_index.min().item<int64_t>() < 0 || instrument_index.max().item<int64_t>() >= n_instruments){
+        return "instrument_index out of [0, n_instruments)";
+    }
+    return "";
+}
+
+torch::Tensor PricingService::price(
+    std::shared_ptr<const SegmentFunction> curve,
+    torch::Tensor cashflow_times,
+    torch::Tensor cashflow_amounts,
+    torch::Tensor instrument_index,
+    int64_t n_instruments
+){
+    return submit(curve, cashflow_times, cashflow_amounts, instrument_index, n_instruments).get();
+}
+
+void PricingService::shutdown(){
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping && workers.empty()){
+            return;
+        }
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    for (std::thread& worker : workers){
+        if (worker.joinable()){
+            worker.join();
+        }
+    }
+    workers.clear();
+}
+
+size_t PricingService::num_batches() const {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return batch_count;
+}
+
+size_t PricingService::num_requests() const {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return request_count;
+}
+
+void PricingService::_worker_loop(){
+    // intra-op settings are per thread when libtorch is built against OpenMP, so every worker sets its own
+    if (config.intra_op_threads > 0){
+        at::set_num_threads(config.intra_op_threads);
+    }
+    precision_policy::PrecisionGuard precision_guard(config.precision);
+    while (true){
+        std::vector<PendingRequest> batch = _next_batch();
+        if (batch.empty()){
+            return;
+        }
+        _evaluate_batch(batch);
+    }
+}
+
+/**
+ * @brief Blocks until a batch is ready and removes it from the queue. An empty batch means the service is stopping.
+ *
+ * The batch is keyed on the queued request with the earliest close_by time: it is released once that time has
+ * passed or once the requests on the same curve hold max_batch_cashflows, and every request on that curve which
+ * still fits is taken along with it.
+ */
+std::vector<PricingService::PendingRequest> PricingService::_next_batch(){
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    std::deque<PendingRequest>::iterator first;
+    while (true){
+        if (queue.empty()){
+            if (stopping){
+                return std::vector<PendingRequest>();
+            }
+            queue_cv.wait(lock);
+            continue;
+        }
+        first = queue.begin();
+        for (auto it = queue.begin(); it != queue.end(); ++it){
+            if (it->close_by < first->close_by){
+                first = it;
+            }
+        }
+        int64_t n_cashflows = 0;
+        for (const PendingRequest& request : queue){
+            if (request.curve == first->curve){
+                n_cashflows += request.cashflow_times.numel();
+            }
+        }
+        Clock::time_point close_by = first->close_by;
+        if (stopping || n_cashflows >= config.max_batch_cashflows || Clock::now() >= close_by){
+            break;
+        }
+        queue_cv.wait_until(lock, close_by);
+    }
+
+    std::shared_ptr<const SegmentFunction> curve = first->curve;
+    std::vector<PendingRequest> batch;
+    batch.push_back(std::move(*first));
+    queue.erase(first);
+    int64_t n_cashflows = batch[0].cashflow_times.numel();
+    for (auto it = queue.begin(); it != queue.end();){
+        const int64_t request_cashflows = it->cashflow_times.numel();
+        if (it->curve == curve && n_cashflows + request_cashflows <= config.max_batch_cashflows){
+            n_cashflows += request_cashflows;
+            batch.push_back(std::move(*it));
+            it = queue.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    batch_count++;
+    request_count += batch.size();
+    const bool has_more = not queue.empty();
+    lock.unlock();
+    if (has_more){
+        queue_cv.notify_one();
+    }
+    return batch;
+}
+
+void PricingService::_evaluate_batch(std::vector<PendingRequest>& batch){
+    std::vector<torch::Tensor> results;
+    try {
+        torch::NoGradGuard no_grad;
+        std::vector<torch::Tensor> times, amounts, indices;
+        int64_t n_instruments = 0;
+        for (const PendingRequest& request : batch){
+            times.push_back(precision_policy::cast(request.cashflow_times));
+            amounts.push_back(precision_policy::cast(request.cashflow_amounts));
+            indices.push_back(request.instrument_index + n_instruments);
+            n_instruments += request.n_instruments;
+        }
+        torch::Tensor discount_factors = (*batch[0].curve)(torch::cat(times));
+        torch::Tensor discounted = torch::cat(amounts) * discount_factors;
+        torch::Tensor pvs = torch::zeros(n_instruments, discounted.options()).index_add_(0, torch::cat(indices), discounted);
+
+        int64_t offset = 0;
+        for (const PendingRequest& request : batch){
+            results.push_back(pvs.narrow(0, offset, request.n_instruments).clone());
+            offset += request.n_instruments;
+        }
+    }
+    catch (...) {
+        std::exception_ptr error = std::current_exception();
+        for (PendingRequest& request : batch){
+            request.result.set_exception(error);
+        }
+        return;
+    }
+    for (int i = 0; i < batch.size(); ++i){
+        batch[i].result.set_value(results[i]);
+    }
+}
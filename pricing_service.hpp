@@ -0,0 +1,112 @@
+//
+//  pricing_service.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef pricing_service_hpp
+#define pricing_service_hpp
+
+#include <stdio.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <torch/script.h>
+
+#include "precision_policy.hpp"
+#include "segment_functions.hpp"
+
+struct PricingServiceConfig {
+    int num_workers = 1;
+    // <= 0 leaves the corresponding libtorch setting untouched
+    int inter_op_threads = 0;
+    int intra_op_threads = 1;
+    // a batch is closed as soon as it holds this many cashflows
+    int64_t max_batch_cashflows = 1 << 16;
+    // how long the oldest queued request may wait for others to join its batch
+    std::chrono::microseconds max_batch_delay = std::chrono::microseconds(200);
+    precision_policy::Precision precision = precision_policy::Precision::Float64;
+};
+
+/**
+ * @brief In-process pricing service which coalesces small concurrent requests into batched curve evaluations.
+ *
+ * A request prices a set of instruments on a discount curve: cashflow k pays cashflow_amounts[k] at
+ * cashflow_times[k] and belongs to instrument instrument_index[k], and the result is the tensor of
+ * \f$ PV_j = \sum_{k, index_k = j} amount_k \cdot D(t_k) \f$ with D the SegmentFunction passed in.
+ *
+ * Workers pull requests from a single queue. Requests sharing the same curve are concatenated into one
+ * evaluation, until either the batch reaches max_batch_cashflows or the oldest request has waited
+ * max_batch_delay. A request deadline earlier than that closes the batch sooner, which bounds tail latency.
+ */
+class PricingService {
+
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        PricingService(PricingServiceConfig in_config = PricingServiceConfig());
+        ~PricingService();
+
+        PricingService(const PricingService&) = delete;
+        PricingService& operator=(const PricingService&) = delete;
+
+        std::future<torch::Tensor> submit(
+            std::shared_ptr<const SegmentFunction> curve,
+            torch::Tensor cashflow_times,
+            torch::Tensor cashflow_amounts,
+            torch::Tensor instrument_index,
+            int64_t n_instruments,
+            Clock::time_point deadline = Clock::time_point::max()
+        );
+        torch::Tensor price(
+            std::shared_ptr<const SegmentFunction> curve,
+            torch::Tensor cashflow_times,
+            torch::Tensor cashflow_amounts,
+            torch::Tensor instrument_index,
+            int64_t n_instruments
+        );
+
+        void shutdown();
+
+        size_t num_batches() const;
+        size_t num_requests() const;
+
+    private:
+        struct PendingRequest {
+            std::shared_ptr<const SegmentFunction> curve;
+            torch::Tensor cashflow_times;
+            torch::Tensor cashflow_amounts;
+            torch::Tensor instrument_index;
+            int64_t n_instruments;
+            Clock::time_point close_by;
+            std::promise<torch::Tensor> result;
+        };
+
+        PricingServiceConfig config;
+        std::deque<PendingRequest> queue;
+        std::vector<std::thread> workers;
+        mutable std::mutex queue_mutex;
+        std::condition_variable queue_cv;
+        bool stopping;
+        size_t batch_count;
+        size_t request_count;
+
+        static std::string _validate(
+            const torch::Tensor& cashflow_times,
+            const torch::Tensor& cashflow_amounts,
+            const torch::Tensor& instrument_index,
+            int64_t n_instruments
+        );
+        void _worker_loop();
+        std::vector<PendingRequest> _next_batch();
+        static void _evaluate_batch(std::vector<PendingRequest>& batch);
+};
+
+#endif /* pricing_service_hpp */
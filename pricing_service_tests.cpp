@@ -0,0 +1,113 @@
+//
+//  pricing_service_tests.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <iostream>
+#include <string>
+#include "pricing_service.hpp"
+#include "pricing_service_tests.hpp"
+
+namespace {
+    std::shared_ptr<const SegmentFunction> build_flat_curve(){
+        std::vector<double> rate = {-0.05};
+        std::vector<TorchPolynomial> polynomials{TorchPolynomial(1.0, false)};
+        return std::make_shared<const SegmentFunction>(torch::tensor(rate), polynomials);
+    }
+}
+
+int pricing_service_tests::test_single_request(){
+    std::shared_ptr<const SegmentFunction> curve = build_flat_curve();
+    PricingService service;
+
+    // two instruments: a 1y zero coupon and a 2y annual coupon bond
+    std::vector<double> times = {1, 1, 2};
+    std::vector<double> amounts = {1, 0.05, 1.05};
+    std::vector<int64_t> index = {0, 1, 1};
+    torch::Tensor pvs = service.price(curve, torch::tensor(times), torch::tensor(amounts), torch::tensor(index), 2);
+
+    double target_0 = std::exp(-0.05);
+    double target_1 = 0.05 * std::exp(-0.05) + 1.05 * std::exp(-0.1);
+    bool is_correct = (pvs.size(0) == 2)
+        && (std::abs(pvs[0].item<double>() - target_0) < 1e-12)
+        && (std::abs(pvs[1].item<double>() - target_1) < 1e-12);
+    std::string output_message = is_correct ? "Single request passed" : "Single request FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
+
+int pricing_service_tests::test_coalescing(){
+    std::shared_ptr<const SegmentFunction> curve = build_flat_curve();
+    PricingServiceConfig config;
+    config.num_workers = 2;
+    config.max_batch_delay = std::chrono::milliseconds(50);
+    PricingService service(config);
+
+    const int n_requests = 32;
+    std::vector<std::future<torch::Tensor>> futures;
+    for (int i = 0; i < n_requests; ++i){
+        std::vector<double> times = {static_cast<double>(i + 1)};
+        std::vector<double> amounts = {1};
+        std::vector<int64_t> index = {0};
+        futures.push_back(service.submit(curve, torch::tensor(times), torch::tensor(amounts), torch::tensor(index), 1));
+    }
+    bool values_are_correct = true;
+    for (int i = 0; i < n_requests; ++i){
+        torch::Tensor pv = futures[i].get();
+        values_are_correct &= (std::abs(pv[0].item<double>() - std::exp(-0.05 * (i + 1))) < 1e-12);
+    }
+    bool is_coalesced = (service.num_requests() == n_requests) && (service.num_batches() < n_requests);
+    bool is_correct = values_are_correct && is_coalesced;
+    std::string output_message = is_correct ? "Coalescing passed" : "Coalescing FAILED";
+    std::cout << output_message << " (" << service.num_requests() << " requests in " << service.num_batches() << " batches)\n";
+    return (int) not is_correct;
+}
+
+
+int pricing_service_tests::test_malformed_request(){
+    std::shared_ptr<const SegmentFunction> curve = build_flat_curve();
+    PricingServiceConfig config;
+    config.max_batch_delay = std::chrono::milliseconds(50);
+    PricingService service(config);
+
+    std::vector<double> times = {1, 2};
+    std::vector<double> amounts = {1, 1};
+    std::vector<double> short_amounts = {1};
+    std::vector<double> long_amounts = {1, 1, 1};
+    std::vector<double> long_times = {1, 2, 3};
+    std::vector<int64_t> index = {0, 1};
+    std::vector<int64_t> out_of_range_index = {0, 2};
+    std::vector<int64_t> long_index = {0, 0, 1};
+
+    // submitted together so that they would share a batch: the two size mismatches cancel out in a concatenation
+    std::future<torch::Tensor> good_before = service.submit(curve, torch::tensor(times), torch::tensor(amounts), torch::tensor(index), 2);
+    std::future<torch::Tensor> bad_index = service.submit(curve, torch::tensor(times), torch::tensor(amounts), torch::tensor(out_of_range_index), 2);
+    std::future<torch::Tensor> bad_short = service.submit(curve, torch::tensor(times), torch::tensor(short_amounts), torch::tensor(index), 2);
+    std::future<torch::Tensor> bad_long = service.submit(curve, torch::tensor(times), torch::tensor(long_amounts), torch::tensor(long_index), 2);
+    std::future<torch::Tensor> good_after = service.submit(curve, torch::tensor(long_times), torch::tensor(long_amounts), torch::tensor(long_index), 2);
+
+    auto fails = [](std::future<torch::Tensor>& future){
+        try {
+            future.get();
+        }
+        catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    bool bad_are_rejected = fails(bad_index) && fails(bad_short) && fails(bad_long);
+
+    torch::Tensor pvs_before = good_before.get();
+    torch::Tensor pvs_after = good_after.get();
+    bool good_are_correct = (std::abs(pvs_before[0].item<double>() - std::exp(-0.05)) < 1e-12)
+        && (std::abs(pvs_before[1].item<double>() - std::exp(-0.1)) < 1e-12)
+        && (std::abs(pvs_after[0].item<double>() - std::exp(-0.05) - std::exp(-0.1)) < 1e-12)
+        && (std::abs(pvs_after[1].item<double>() - std::exp(-0.15)) < 1e-12);
+
+    bool is_correct = bad_are_rejected && good_are_correct;
+    std::string output_message = is_correct ? "Malformed request passed" : "Malformed request FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
\ No newline at end of file
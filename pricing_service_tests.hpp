@@ -0,0 +1,20 @@
+//
+//  pricing_service_tests.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef pricing_service_tests_hpp
+#define pricing_service_tests_hpp
+
+#include <iostream>
+#include <string>
+
+namespace pricing_service_tests {
+    int test_single_request();
+    int test_coalescing();
+    int test_malformed_request();
+}
+
+#endif /* pricing_service_tests_hpp */
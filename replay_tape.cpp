@@ -0,0 +1,124 @@
+//
+//  replay_tape.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <torch/csrc/jit/frontend/tracer.h>
+#include "replay_tape.hpp"
+
+ReplayTape::ReplayTape(Objective in_objective, const std::vector<torch::Tensor>& in_parameters):
+    objective(in_objective){
+        torch::jit::Stack inputs;
+        for (const torch::Tensor& parameter : in_parameters){
+            torch::Tensor buffer = parameter.detach().clone();
+            buffer.set_requires_grad(true);
+            parameter_buffers.push_back(buffer);
+            inputs.push_back(buffer);
+        }
+
+        auto traced_objective = [this](torch::jit::Stack traced_inputs){
+            std::vector<torch::Tensor> traced_parameters;
+            for (const c10::IValue& input : traced_inputs){
+                traced_parameters.push_back(input.toTensor());
+            }
+            return torch::jit::Stack{objective(traced_parameters)};
+        };
+        auto no_variable_names = [](const torch::autograd::Variable&){ return std::string(); };
+        // strict=false: the objective returns a single tensor, no container outputs to check
+        std::shared_ptr<torch::jit::tracer::TracingState> state =
+            torch::jit::tracer::trace(inputs, traced_objective, no_variable_names, false).first;
+
+        recorded_graph = state->graph;
+        function = std::make_shared<torch::jit::GraphFunction>("replay_tape_objective", recorded_graph, nullptr);
+}
+
+std::shared_ptr<torch::jit::Graph> ReplayTape::graph() const {
+    return recorded_graph;
+}
+
+void ReplayTape::_load_parameters(const std::vector<torch::Tensor>& parameters){
+    TORCH_CHECK(
+        parameters.size() == parameter_buffers.size(),
+        "ReplayTape: recorded with ", parameter_buffers.size(), " parameters, replayed with ", parameters.size()
+    );
+    // copy_ would broadcast a mismatched shape silently
+    for (int i = 0; i < parameters.size(); ++i){
+        TORCH_CHECK(
+            parameters[i].sizes() == parameter_buffers[i].sizes(),
+            "ReplayTape: parameter ", i, " recorded with shape ", parameter_buffers[i].sizes(),
+            ", replayed with shape ", parameters[i].sizes()
+        );
+    }
+    torch::NoGradGuard no_grad;
+    for (int i = 0; i < parameters.size(); ++i){
+        parameter_buffers[i].copy_(parameters[i]);
+    }
+}
+
+torch::Tensor ReplayTape::_run(){
+    torch::jit::Stack stack(parameter_buffers.begin(), parameter_buffers.end());
+    function->run(stack);
+    return stack.back().toTensor();
+}
+
+/**
+ * @brief Replays the recorded graph on new parameter values, without recording anything for backward.
+ */
+torch::Tensor ReplayTape::forward(const std::vector<torch::Tensor>& parameters){
+    _load_parameters(parameters);
+    torch::NoGradGuard no_grad;
+    return _run();
+}
+
+/**
+ * @brief Replays forward and backward, returns the objective value and fills gradients.
+ *
+ * The gradients alias the parameter buffers' .grad() and are overwritten by the next call, clone them to keep them.
+ */
+torch::Tensor ReplayTape::value_and_gradient(const std::vector<torch::Tensor>& parameters, std::vector<torch::Tensor>& gradients){
+    _load_parameters(parameters);
+    for (torch::Tensor& buffer : parameter_buffers){
+        if (buffer.grad().defined()){
+            buffer.mutable_grad().zero_();
+        }
+    }
+    torch::Tensor value = _run();
+    value.backward();
+
+    gradients.clear();
+    for (const torch::Tensor& buffer : parameter_buffers){
+        gradients.push_back(buffer.grad().defined() ? buffer.grad() : torch::zeros_like(buffer));
+    }
+    return value.detach();
+}
+
+/**
+ * @brief Compares a replay with a fresh eager evaluation of the objective, values and gradients.
+ *
+ * A mismatch means the objective's structure depends on the parameter values and the tape has to be re-recorded.
+ */
+bool ReplayTape::matches_eager(const std::vector<torch::Tensor>& parameters, double tolerance){
+    std::vector<torch::Tensor> replay_gradients;
+    torch::Tensor replay_value = value_and_gradient(parameters, replay_gradients);
+
+    std::vector<torch::Tensor> eager_parameters;
+    for (const torch::Tensor& parameter : parameters){
+        torch::Tensor eager_parameter = parameter.detach().clone();
+        eager_parameter.set_requires_grad(true);
+        eager_parameters.push_back(eager_parameter);
+    }
+    torch::Tensor eager_value = objective(eager_parameters);
+    eager_value.backward();
+
+    bool is_matching = torch::allclose(replay_value, eager_value.detach(), tolerance, tolerance);
+    for (int i = 0; i < eager_parameters.size() && is_matching; ++i){
+        torch::Tensor eager_gradient = eager_parameters[i].grad();
+        if (not eager_gradient.defined()){
+            eager_gradient = torch::zeros_like(eager_parameters[i]);
+        }
+        is_matching = torch::allclose(replay_gradients[i], eager_gradient, tolerance, tolerance);
+    }
+    return is_matching;
+}
@@ -0,0 +1,65 @@
+//
+//  replay_tape.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef replay_tape_hpp
+#define replay_tape_hpp
+
+#include <stdio.h>
+#include <functional>
+#include <memory>
+#include <torch/script.h>
+#include <torch/csrc/jit/api/function_impl.h>
+
+/**
+ * @brief Record-once, replay-many plan for a pricing or calibration objective.
+ *
+ * The objective maps a fixed list of parameter tensors to a scalar, typically by building TorchPolynomial and
+ * SegmentFunction objects from them and pricing cashflows. The constructor runs it once under the libtorch tracer,
+ * which flattens the whole call tree into a static graph of aten ops. Replays then run that graph on new parameter
+ * values, without rebuilding any TorchPolynomial / SegmentFunction and without going back through their operators,
+ * and the backward pass is the one the graph executor derives for the recorded graph.
+ *
+ * What a replay saves is the host-side work of the objective, not autograd bookkeeping: value_and_gradient() runs
+ * the graph with GradMode on, so libtorch still records a fresh autograd graph (one node per recorded op) on every
+ * call, as any forward pass does before backward. forward() runs under NoGradGuard and records nothing.
+ *
+ * Parameter values are copied into buffers allocated at record time, and gradients accumulate into the same
+ * buffers' .grad() on every call. The parameters passed to a replay must match the recorded ones in number and
+ * shape.
+ *
+ * Only tensor data flow is recorded. Exp coefficients, including the 1/c factors of SegmentFunction::antiderivative,
+ * stay in that data flow and replay with their new values. What the objective decides on the host with .item() is
+ * frozen at its record-time value: degrees after trailing-zero cleanup, the order of the terms sorted by exp
+ * coefficient, and the c == 0 branch of the antiderivative. The structure of the objective must therefore not
+ * depend on the parameter values. matches_eager() checks a replay against a fresh eager run.
+ *
+ * A tape holds mutable buffers: use one tape per thread.
+ */
+class ReplayTape {
+
+    public:
+        using Objective = std::function<torch::Tensor(const std::vector<torch::Tensor>&)>;
+
+        ReplayTape(Objective in_objective, const std::vector<torch::Tensor>& in_parameters);
+
+        torch::Tensor forward(const std::vector<torch::Tensor>& parameters);
+        torch::Tensor value_and_gradient(const std::vector<torch::Tensor>& parameters, std::vector<torch::Tensor>& gradients);
+        bool matches_eager(const std::vector<torch::Tensor>& parameters, double tolerance);
+
+        std::shared_ptr<torch::jit::Graph> graph() const;
+
+    private:
+        Objective objective;
+        std::shared_ptr<torch::jit::Graph> recorded_graph;
+        std::shared_ptr<torch::jit::GraphFunction> function;
+        std::vector<torch::Tensor> parameter_buffers;
+
+        void _load_parameters(const std::vector<torch::Tensor>& parameters);
+        torch::Tensor _run();
+};
+
+#endif /* replay_tape_hpp */
@@ -0,0 +1,79 @@
+//
+//  replay_tape_tests.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <iostream>
+#include <string>
+#include "replay_tape.hpp"
+#include "segment_functions.hpp"
+#include "replay_tape_tests.hpp"
+
+namespace {
+    // PV of a strip of cashflows discounted with exp(c t) * P(t), parameters are {c, coefficients of P}
+    torch::Tensor price_cashflows(const std::vector<torch::Tensor>& parameters){
+        std::vector<TorchPolynomial> polynomials{TorchPolynomial(parameters[1])};
+        SegmentFunction discount_curve(parameters[0], polynomials);
+        torch::Tensor times = torch::linspace(0.5, 10, 20, torch::kFloat64);
+        torch::Tensor amounts = 0.02 * torch::ones(20, torch::kFloat64);
+        return torch::sum(amounts * discount_curve(times));
+    }
+
+    // goes through + on equal rates, derivative() and antiderivative() of the curve
+    torch::Tensor integrate_forward_rates(const std::vector<torch::Tensor>& parameters){
+        std::vector<TorchPolynomial> polynomials{TorchPolynomial(parameters[1])};
+        SegmentFunction discount_curve(parameters[0], polynomials);
+        SegmentFunction doubled_curve = discount_curve + discount_curve;
+        SegmentFunction slope_curve = doubled_curve.derivative();
+        SegmentFunction integrated_curve = doubled_curve.antiderivative();
+        torch::Tensor times = torch::linspace(0.5, 10, 20, torch::kFloat64);
+        return torch::sum(slope_curve(times)) + torch::sum(integrated_curve(times));
+    }
+
+    std::vector<torch::Tensor> build_parameters(double rate, double slope){
+        std::vector<double> exp_coefs = {-rate};
+        std::vector<double> coefs = {1, slope, 0.001};
+        return std::vector<torch::Tensor>{torch::tensor(exp_coefs), torch::tensor(coefs)};
+    }
+}
+
+int replay_tape_tests::test_replay(){
+    ReplayTape tape(price_cashflows, build_parameters(0.03, 0.01));
+
+    std::vector<torch::Tensor> new_parameters = build_parameters(0.035, -0.005);
+    torch::Tensor replayed_value = tape.forward(new_parameters);
+    torch::Tensor eager_value = price_cashflows(new_parameters);
+    bool forward_matches = torch::allclose(replayed_value, eager_value, 1e-12, 1e-12);
+    bool gradients_match = tape.matches_eager(new_parameters, 1e-10);
+
+    bool is_correct = forward_matches && gradients_match;
+    std::string output_message = is_correct ? "Replay passed" : "Replay FAILED";
+    std::cout << output_message << "\n";
+    if (not is_correct){
+        std::cout << "Replayed value: " << replayed_value.item<double>() << " eager value: " << eager_value.item<double>() << "\n";
+    }
+    return (int) not is_correct;
+}
+
+
+int replay_tape_tests::test_replay_derivative(){
+    ReplayTape tape(integrate_forward_rates, build_parameters(0.03, 0.01));
+
+    std::vector<torch::Tensor> new_parameters = build_parameters(0.045, -0.005);
+    torch::Tensor replayed_value = tape.forward(new_parameters);
+    torch::Tensor eager_value = integrate_forward_rates(new_parameters);
+    torch::Tensor record_time_value = integrate_forward_rates(build_parameters(0.03, 0.01));
+    bool forward_matches = torch::allclose(replayed_value, eager_value, 1e-12, 1e-12)
+        && not torch::allclose(replayed_value, record_time_value, 1e-6, 1e-6);
+    bool gradients_match = tape.matches_eager(new_parameters, 1e-10);
+
+    bool is_correct = forward_matches && gradients_match;
+    std::string output_message = is_correct ? "Replay through derivative passed" : "Replay through derivative FAILED";
+    std::cout << output_message << "\n";
+    if (not is_correct){
+        std::cout << "Replayed value: " << replayed_value.item<double>() << " eager value: " << eager_value.item<double>() << "\n";
+    }
+    return (int) not is_correct;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+//
+//  replay_tape_tests.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef replay_tape_tests_hpp
+#define replay_tape_tests_hpp
+
+#include <iostream>
+#include <string>
+
+namespace replay_tape_tests {
+    int test_replay();
+    int test_replay_derivative();
+}
+
+#endif /* replay_tape_tests_hpp */
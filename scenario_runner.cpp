@@ -0,0 +1,286 @@
+//
+//  scenario_runner.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <ATen/Parallel.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include "scenario_runner.hpp"
+#include "segment_functions.hpp"
+#include "precision_policy.hpp"
+
+namespace {
+    // room for each worker's error message in shared memory, longer messages are truncated
+    const size_t error_message_size = 512;
+}
+
+ScenarioRunner::ScenarioRunner(ScenarioRunnerConfig in_config):
+    config(in_config),
+    run_count(0){}
+
+/**
+ * @brief Returns an empty string for well-formed inputs, otherwise what is wrong with them.
+ *
+ * Checked in the parent, before anything is shared or forked, so that a malformed run fails with a clear message
+ * instead of one opaque error per worker.
+ */
+std::string ScenarioRunner::_validate(const ScenarioInputs& inputs){
+    if (not inputs.exp_coefs.defined() || not inputs.polynomial_coefs.defined() || not inputs.cashflow_times.defined()
+        || not inputs.cashflow_amounts.defined() || not inputs.instrument_index.defined()){
+        return "undefined input tensor";
+    }
+    if (inputs.exp_coefs.dim() != 2){
+        return "exp_coefs must be [S, T]";
+    }
+    if (inputs.polynomial_coefs.dim() != 3 || inputs.polynomial_coefs.size(0) != inputs.exp_coefs.size(0)
+        || inputs.polynomial_coefs.size(1) != inputs.exp_coefs.size(1) || inputs.polynomial_coefs.size(2) == 0){
+        return "polynomial_coefs must be [S, T, degree + 1] with exp_coefs [S, T]";
+    }
+    if (inputs.n_instruments < 0){
+        return "negative n_instruments";
+    }
+    const int64_t n_cashflows = inputs.cashflow_times.numel();
+    if (inputs.cashflow_amounts.numel() != n_cashflows || inputs.instrument_index.numel() != n_cashflows){
+        return "cashflow_times, cashflow_amounts and instrument_index must have the same number of elements";
+    }
+    if (n_cashflows == 0){
+        return "";
+    }
+    if (inputs.instrument_index.is_floating_point() || inputs.instrument_index.is_complex()){
+        return "instrument_index must be integral";
+    }
+    if (inputs.instrument_index.min().item<int64_t>() < 0 || inputs.instrument_index.max().item<int64_t>() >= inputs.n_instruments){
+        return "instrument_index out of [0, n_instruments)";
+    }
+    return "";
+}
+
+/**
+ * @brief Shards the scenarios across forked workers and blocks until all of them are priced.
+ *
+ * Curve coefficients, cashflows and results are held in the precision policy's dtype. progress, if given, is
+ * called from the calling process every config.progress_interval, and whenever a worker finishes, with the number
+ * of scenarios done so far. Without it the calling process just blocks until the workers exit.
+ *
+ * Malformed inputs throw std::invalid_argument before any worker starts. A failing worker reports its exception
+ * message through shared memory, and run() throws a std::runtime_error listing every failed worker's message.
+ */
+ScenarioResults ScenarioRunner::run(const ScenarioInputs& inputs, ProgressCallback progress){
+    const std::string error = _validate(inputs);
+    if (not error.empty()){
+        throw std::invalid_argument("ScenarioRunner: " + error);
+    }
+    const torch::Dtype dtype = precision_policy::dtype();
+    const int64_t n_scenarios = inputs.exp_coefs.size(0);
+    const std::string prefix = "/quick_potatoes_" + std::to_string(getpid()) + "_" + std::to_string(run_count++) + "_";
+
+    auto share = [&prefix](const std::string& suffix, const torch::Tensor& source, torch::Dtype share_dtype){
+        torch::Tensor contiguous_source = source.detach().to(share_dtype).contiguous();
+        std::shared_ptr<SharedMemoryBlock> block = SharedMemoryBlock::for_tensor(prefix + suffix, contiguous_source.sizes(), share_dtype);
+        torch::Tensor shared = SharedMemoryBlock::as_owning_tensor(block, contiguous_source.sizes(), share_dtype);
+        shared.copy_(contiguous_source);
+        return shared;
+    };
+    auto allocate = [&prefix](const std::string& suffix, torch::IntArrayRef sizes, torch::Dtype allocate_dtype){
+        std::shared_ptr<SharedMemoryBlock> block = SharedMemoryBlock::for_tensor(prefix + suffix, sizes, allocate_dtype);
+        return SharedMemoryBlock::as_owning_tensor(block, sizes, allocate_dtype).zero_();
+    };
+
+    ScenarioInputs shared_inputs;
+    shared_inputs.exp_coefs = share("exp_coefs", inputs.exp_coefs, dtype);
+    shared_inputs.polynomial_coefs = share("polynomial_coefs", inputs.polynomial_coefs, dtype);
+    shared_inputs.cashflow_times = share("cashflow_times", inputs.cashflow_times.reshape(-1), dtype);
+    shared_inputs.cashflow_amounts = share("cashflow_amounts", inputs.cashflow_amounts.reshape(-1), dtype);
+    shared_inputs.instrument_index = share("instrument_index", inputs.instrument_index.reshape(-1), torch::kLong);
+    shared_inputs.n_instruments = inputs.n_instruments;
+    shared_inputs.origin = inputs.origin;
+
+    ScenarioResults shared_results;
+    shared_results.pvs = allocate("pvs", {n_scenarios, inputs.n_instruments}, dtype);
+    if (config.compute_sensitivities){
+        shared_results.exp_coef_sensitivities = allocate("exp_coef_sensitivities", shared_inputs.exp_coefs.sizes(), dtype);
+        shared_results.polynomial_sensitivities = allocate("polynomial_sensitivities", shared_inputs.polynomial_coefs.sizes(), dtype);
+    }
+
+    // std::atomic<int64_t> is lock-free on the platforms we target, so it can be shared between processes
+    SharedMemoryBlock counter_block(prefix + "completed", sizeof(std::atomic<int64_t>));
+    std::atomic<int64_t>* completed = new (counter_block.data()) std::atomic<int64_t>(0);
+
+    // workers write a byte here as they finish, so that progress reporting wakes up without waiting for the timer
+    int wake_pipe[2] = {-1, -1};
+    if (progress && pipe(wake_pipe) != 0){
+        throw std::runtime_error("ScenarioRunner could not create its wake-up pipe");
+    }
+
+    const int n_workers = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(config.num_workers, n_scenarios)));
+    // one zero-initialised message per worker, left empty unless the worker fails
+    SharedMemoryBlock error_block(prefix + "errors", n_workers * error_message_size);
+    char* error_messages = static_cast<char*>(error_block.data());
+
+    std::vector<pid_t> children;
+    for (int w = 0; w < n_workers; ++w){
+        const int64_t first_scenario = n_scenarios * w / n_workers;
+        const int64_t last_scenario = n_scenarios * (w + 1) / n_workers;
+        pid_t pid = fork();
+        if (pid < 0){
+            for (pid_t child : children){
+                kill(child, SIGKILL);
+                waitpid(child, nullptr, 0);
+            }
+            if (progress){
+                close(wake_pipe[0]);
+                close(wake_pipe[1]);
+            }
+            throw std::runtime_error("ScenarioRunner could not fork a worker");
+        }
+        if (pid == 0){
+            if (progress){
+                close(wake_pipe[0]);
+            }
+            int exit_status = 0;
+            char* error_message = error_messages + w * error_message_size;
+            try {
+                at::set_num_threads(std::max(config.threads_per_worker, 1));
+                _price_scenarios(shared_inputs, shared_results, first_scenario, last_scenario, config.compute_sensitivities, completed);
+            }
+            catch (const c10::Error& worker_error) {
+                exit_status = 1;
+                std::strncpy(error_message, worker_error.what_without_backtrace(), error_message_size - 1);
+            }
+            catch (const std::exception& worker_error) {
+                exit_status = 1;
+                std::strncpy(error_message, worker_error.what(), error_message_size - 1);
+            }
+            catch (...) {
+                exit_status = 1;
+                std::strncpy(error_message, "unknown exception", error_message_size - 1);
+            }
+            if (progress){
+                const char done = 1;
+                ssize_t n_written = write(wake_pipe[1], &done, 1);
+                (void) n_written;
+            }
+            // _exit skips destructors, the shared memory belongs to the parent
+            _exit(exit_status);
+        }
+        children.push_back(pid);
+    }
+
+    std::vector<std::string> failures;
+    std::vector<bool> is_running(children.size(), true);
+    size_t n_running = children.size();
+    // options is WNOHANG to only collect the workers which already exited, 0 to block until all of them have
+    auto reap_workers = [&](int options){
+        for (int w = 0; w < children.size(); ++w){
+            if (not is_running[w]){
+                continue;
+            }
+            int status = 0;
+            pid_t reaped = waitpid(children[w], &status, options);
+            while (reaped < 0 && errno == EINTR){
+                reaped = waitpid(children[w], &status, options);
+            }
+            if (reaped == children[w]){
+                is_running[w] = false;
+                n_running--;
+                if (WIFSIGNALED(status)){
+                    failures.push_back("worker " + std::to_string(w) + " killed by signal " + std::to_string(WTERMSIG(status)));
+                }
+                else if (not WIFEXITED(status) || WEXITSTATUS(status) != 0){
+                    const char* message = error_messages + w * error_message_size;
+                    failures.push_back("worker " + std::to_string(w) + ": " + ((message[0] != '\0') ? message : "exited with an error"));
+                }
+            }
+            else if (reaped < 0){
+                // not our child any more, nothing left to wait for
+                is_running[w] = false;
+                n_running--;
+                failures.push_back("worker " + std::to_string(w) + " could not be waited for");
+            }
+        }
+    };
+
+    if (not progress){
+        reap_workers(0);
+    }
+    else {
+        close(wake_pipe[1]);
+        bool is_pipe_open = true;
+        while (true){
+            reap_workers(is_pipe_open ? WNOHANG : 0);
+            progress(completed->load(), n_scenarios);
+            if (n_running == 0){
+                break;
+            }
+            pollfd wake_fd = {wake_pipe[0], POLLIN, 0};
+            if (poll(&wake_fd, 1, static_cast<int>(config.progress_interval.count())) > 0){
+                char buffer[64];
+                // end of file once every worker has closed its end, which they only do by exiting
+                is_pipe_open = (read(wake_pipe[0], buffer, sizeof(buffer)) != 0);
+            }
+        }
+        close(wake_pipe[0]);
+    }
+    if (not failures.empty()){
+        std::string message = "ScenarioRunner: " + std::to_string(failures.size()) + " worker(s) failed";
+        for (const std::string& failure : failures){
+            message += "; " + failure;
+        }
+        throw std::runtime_error(message);
+    }
+    return shared_results;
+}
+
+/**
+ * @brief Worker body: prices scenarios [first_scenario, last_scenario) and writes their rows of the results.
+ *
+ * The whole slice goes through a single SegmentFunction::evaluate_batched call on the padded coefficients, so every
+ * input coefficient, padding and repeated exp coefficients included, gets its own sensitivity. Each scenario's
+ * coefficients only reach its own row of PVs, so one backward pass on the slice total yields every scenario's
+ * sensitivities at once.
+ */
+void ScenarioRunner::_price_scenarios(
+    const ScenarioInputs& shared_inputs,
+    ScenarioResults& shared_results,
+    int64_t first_scenario,
+    int64_t last_scenario,
+    bool compute_sensitivities,
+    std::atomic<int64_t>* completed
+){
+    const int64_t n_scenarios = last_scenario - first_scenario;
+    if (n_scenarios <= 0){
+        return;
+    }
+    torch::Tensor exp_coefs = shared_inputs.exp_coefs.narrow(0, first_scenario, n_scenarios).clone();
+    torch::Tensor polynomial_coefs = shared_inputs.polynomial_coefs.narrow(0, first_scenario, n_scenarios).clone();
+    exp_coefs.set_requires_grad(compute_sensitivities);
+    polynomial_coefs.set_requires_grad(compute_sensitivities);
+
+    const torch::Tensor local_times = shared_inputs.cashflow_times - shared_inputs.origin;
+    // [n_scenarios, K]
+    torch::Tensor discounted = shared_inputs.cashflow_amounts
+        * SegmentFunction::evaluate_batched(exp_coefs, polynomial_coefs, local_times);
+    torch::Tensor pvs = torch::zeros({n_scenarios, shared_inputs.n_instruments}, discounted.options())
+        .index_add(1, shared_inputs.instrument_index, discounted);
+    {
+        torch::NoGradGuard no_grad;
+        shared_results.pvs.narrow(0, first_scenario, n_scenarios).copy_(pvs);
+    }
+
+    if (compute_sensitivities){
+        pvs.sum().backward();
+        torch::NoGradGuard no_grad;
+        shared_results.exp_coef_sensitivities.narrow(0, first_scenario, n_scenarios).copy_(exp_coefs.grad());
+        shared_results.polynomial_sensitivities.narrow(0, first_scenario, n_scenarios).copy_(polynomial_coefs.grad());
+    }
+    completed->fetch_add(n_scenarios);
+}
@@ -0,0 +1,96 @@
+//
+//  scenario_runner.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef scenario_runner_hpp
+#define scenario_runner_hpp
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <torch/script.h>
+
+#include "shared_memory.hpp"
+
+struct ScenarioRunnerConfig {
+    int num_workers = 1;
+    // intra-op threads inside each worker, keep num_workers * threads_per_worker at or below the core count
+    int threads_per_worker = 1;
+    bool compute_sensitivities = true;
+    std::chrono::milliseconds progress_interval = std::chrono::milliseconds(100);
+};
+
+/**
+ * @brief Scenario curves and the portfolio they are applied to.
+ *
+ * Scenario s discounts with \f$ D_s(t) = \sum_i e^{c_{s,i} (t - t_0)} P_{s,i}(t - t_0) \f$: exp_coefs is [S, T] and
+ * polynomial_coefs is [S, T, degree + 1], monomial coefficients padded with zeros, in the local coordinates of a
+ * segment starting at origin \f$ t_0 \f$ as SegmentFunction::shift(t_0) produces them. Local coefficients stay well
+ * conditioned for long-dated segments. Cashflow k pays cashflow_amounts[k] at the absolute time cashflow_times[k]
+ * into instrument instrument_index[k].
+ */
+struct ScenarioInputs {
+    torch::Tensor exp_coefs;
+    torch::Tensor polynomial_coefs;
+    torch::Tensor cashflow_times;
+    torch::Tensor cashflow_amounts;
+    torch::Tensor instrument_index;
+    int64_t n_instruments;
+    double origin = 0;
+};
+
+/**
+ * @brief Per scenario PVs [S, n_instruments], and sensitivities of the total portfolio PV to the scenario curve
+ * coefficients, with the shapes of ScenarioInputs::exp_coefs and ScenarioInputs::polynomial_coefs.
+ *
+ * The tensors view the shared memory the workers wrote into, and keep it mapped for as long as they are alive.
+ */
+struct ScenarioResults {
+    torch::Tensor pvs;
+    torch::Tensor exp_coef_sensitivities;
+    torch::Tensor polynomial_sensitivities;
+};
+
+/**
+ * @brief Prices a large set of curve scenarios across worker processes on one host.
+ *
+ * Inputs are copied once into POSIX shared memory, result buffers are allocated there up front, and num_workers
+ * processes are forked. Each worker takes a contiguous slice of scenarios, prices the whole portfolio on all of
+ * them with one SegmentFunction::evaluate_batched call, and writes the PVs and sensitivities straight into its
+ * rows of the result buffers. A completion counter in shared memory, advanced as each slice is done, lets the
+ * parent report progress. Inputs are validated in the parent before anything is forked, and a failing worker's
+ * exception message is passed back through shared memory.
+ *
+ * Forked workers inherit libtorch's state, so run() should be called before the parent process has started any
+ * OpenMP-parallel work, or with a libtorch build using the native thread pool.
+ */
+class ScenarioRunner {
+
+    public:
+        using ProgressCallback = std::function<void(int64_t completed, int64_t total)>;
+
+        ScenarioRunner(ScenarioRunnerConfig in_config = ScenarioRunnerConfig());
+
+        ScenarioResults run(const ScenarioInputs& inputs, ProgressCallback progress = nullptr);
+
+    private:
+        ScenarioRunnerConfig config;
+        int run_count;
+
+        static std::string _validate(const ScenarioInputs& inputs);
+        static void _price_scenarios(
+            const ScenarioInputs& shared_inputs,
+            ScenarioResults& shared_results,
+            int64_t first_scenario,
+            int64_t last_scenario,
+            bool compute_sensitivities,
+            std::atomic<int64_t>* completed
+        );
+};
+
+#endif /* scenario_runner_hpp */
@@ -0,0 +1,166 @@
+//
+//  scenario_runner_tests.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "scenario_runner.hpp"
+#include "scenario_runner_tests.hpp"
+
+int scenario_runner_tests::test_sharded_run(){
+    // scenario s discounts with exp(-r_s t) * (1 + 0.01 t)
+    const int n_scenarios = 5;
+    torch::Tensor rates = torch::linspace(0.01, 0.05, n_scenarios, torch::kFloat64);
+    ScenarioInputs inputs;
+    inputs.exp_coefs = -rates.reshape({n_scenarios, 1});
+    inputs.polynomial_coefs = torch::zeros({n_scenarios, 1, 2}, torch::kFloat64);
+    inputs.polynomial_coefs.select(2, 0).fill_(1);
+    inputs.polynomial_coefs.select(2, 1).fill_(0.01);
+
+    std::vector<double> times = {1, 2, 3, 5};
+    std::vector<double> amounts = {0.05, 0.05, 1.05, 1};
+    std::vector<int64_t> index = {0, 0, 0, 1};
+    inputs.cashflow_times = torch::tensor(times);
+    inputs.cashflow_amounts = torch::tensor(amounts);
+    inputs.instrument_index = torch::tensor(index);
+    inputs.n_instruments = 2;
+
+    ScenarioRunnerConfig config;
+    config.num_workers = 2;
+    ScenarioRunner runner(config);
+    int64_t last_completed = 0;
+    ScenarioResults results = runner.run(inputs, [&last_completed](int64_t completed, int64_t total){
+        last_completed = completed;
+    });
+
+    bool is_correct = (last_completed == n_scenarios);
+    for (int s = 0; s < n_scenarios; ++s){
+        double rate = rates[s].item<double>();
+        double pv[2] = {0, 0};
+        double rate_sensitivity = 0;
+        for (int k = 0; k < times.size(); ++k){
+            double discounted = amounts[k] * std::exp(-rate * times[k]) * (1 + 0.01 * times[k]);
+            pv[index[k]] += discounted;
+            rate_sensitivity += times[k] * discounted;
+        }
+        is_correct &= (std::abs(results.pvs[s][0].item<double>() - pv[0]) < 1e-10);
+        is_correct &= (std::abs(results.pvs[s][1].item<double>() - pv[1]) < 1e-10);
+        // the exp coefficient is -r
+        is_correct &= (std::abs(results.exp_coef_sensitivities[s][0].item<double>() - rate_sensitivity) < 1e-10);
+    }
+    std::string output_message = is_correct ? "Sharded run passed" : "Sharded run FAILED";
+    std::cout << output_message << "\n";
+    if (not is_correct){
+        std::cout << "PVs: " << results.pvs << "\n";
+    }
+    return (int) not is_correct;
+}
+
+
+int scenario_runner_tests::test_padded_sensitivities(){
+    // two terms per scenario, with zero padding up to degree 2 and, in scenario 0, a repeated exp coefficient
+    const int n_scenarios = 2;
+    const int n_terms = 2;
+    const int n_powers = 3;
+    std::vector<double> exp_coefs = {-0.02, -0.02, -0.03, 0};
+    std::vector<double> polynomial_coefs = {
+        1, 0, 0,   0, 0.01, 0,
+        0.5, 0.002, 0,   0.5, 0, 0
+    };
+    ScenarioInputs inputs;
+    inputs.exp_coefs = torch::tensor(exp_coefs).reshape({n_scenarios, n_terms});
+    inputs.polynomial_coefs = torch::tensor(polynomial_coefs).reshape({n_scenarios, n_terms, n_powers});
+
+    std::vector<double> times = {0.5, 1, 2, 4};
+    std::vector<double> amounts = {0.02, 0.02, 1.02, 1};
+    std::vector<int64_t> index = {0, 0, 0, 1};
+    inputs.cashflow_times = torch::tensor(times);
+    inputs.cashflow_amounts = torch::tensor(amounts);
+    inputs.instrument_index = torch::tensor(index);
+    inputs.n_instruments = 2;
+
+    ScenarioRunnerConfig config;
+    config.num_workers = 2;
+    ScenarioRunner runner(config);
+    ScenarioResults results = runner.run(inputs);
+
+    bool is_correct = true;
+    for (int s = 0; s < n_scenarios; ++s){
+        double pv[2] = {0, 0};
+        for (int i = 0; i < n_terms; ++i){
+            const double exp_coef = exp_coefs[s * n_terms + i];
+            double exp_sensitivity = 0;
+            double polynomial_sensitivities[n_powers] = {0, 0, 0};
+            for (int k = 0; k < times.size(); ++k){
+                double polynomial_value = 0;
+                for (int j = 0; j < n_powers; ++j){
+                    polynomial_value += polynomial_coefs[(s * n_terms + i) * n_powers + j] * std::pow(times[k], j);
+                    // dPV / da_j = sum_k amount_k * exp(c t_k) * t_k^j, also for the zero padding
+                    polynomial_sensitivities[j] += amounts[k] * std::exp(exp_coef * times[k]) * std::pow(times[k], j);
+                }
+                const double discounted = amounts[k] * std::exp(exp_coef * times[k]) * polynomial_value;
+                pv[index[k]] += discounted;
+                exp_sensitivity += times[k] * discounted;
+            }
+            is_correct &= (std::abs(results.exp_coef_sensitivities[s][i].item<double>() - exp_sensitivity) < 1e-10);
+            for (int j = 0; j < n_powers; ++j){
+                is_correct &= (std::abs(results.polynomial_sensitivities[s][i][j].item<double>() - polynomial_sensitivities[j]) < 1e-10);
+            }
+        }
+        is_correct &= (std::abs(results.pvs[s][0].item<double>() - pv[0]) < 1e-10);
+        is_correct &= (std::abs(results.pvs[s][1].item<double>() - pv[1]) < 1e-10);
+    }
+    std::string output_message = is_correct ? "Padded sensitivities passed" : "Padded sensitivities FAILED";
+    std::cout << output_message << "\n";
+    if (not is_correct){
+        std::cout << "Exp coef sensitivities: " << results.exp_coef_sensitivities << "\n";
+        std::cout << "Polynomial sensitivities: " << results.polynomial_sensitivities << "\n";
+    }
+    return (int) not is_correct;
+}
+
+
+int scenario_runner_tests::test_malformed_inputs(){
+    ScenarioInputs inputs;
+    inputs.exp_coefs = torch::zeros({3, 2}, torch::kFloat64);
+    inputs.polynomial_coefs = torch::ones({3, 2, 2}, torch::kFloat64);
+    std::vector<double> times = {1, 2};
+    std::vector<double> amounts = {1, 1};
+    std::vector<int64_t> index = {0, 1};
+    inputs.cashflow_times = torch::tensor(times);
+    inputs.cashflow_amounts = torch::tensor(amounts);
+    inputs.instrument_index = torch::tensor(index);
+    inputs.n_instruments = 2;
+
+    auto is_rejected = [](const ScenarioInputs& malformed_inputs){
+        ScenarioRunnerConfig config;
+        config.num_workers = 2;
+        ScenarioRunner runner(config);
+        try {
+            runner.run(malformed_inputs);
+        }
+        catch (const std::invalid_argument&) {
+            return true;
+        }
+        catch (...) {
+            return false;
+        }
+        return false;
+    };
+
+    ScenarioInputs mismatched_terms = inputs;
+    mismatched_terms.polynomial_coefs = torch::ones({3, 1, 2}, torch::kFloat64);
+    ScenarioInputs mismatched_cashflows = inputs;
+    mismatched_cashflows.cashflow_amounts = torch::ones(3, torch::kFloat64);
+    ScenarioInputs out_of_range = inputs;
+    out_of_range.n_instruments = 1;
+
+    bool is_correct = is_rejected(mismatched_terms) && is_rejected(mismatched_cashflows) && is_rejected(out_of_range);
+    std::string output_message = is_correct ? "Malformed inputs passed" : "Malformed inputs FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
+}
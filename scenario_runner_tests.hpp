@@ -0,0 +1,20 @@
+//
+//  scenario_runner_tests.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef scenario_runner_tests_hpp
+#define scenario_runner_tests_hpp
+
+#include <iostream>
+#include <string>
+
+namespace scenario_runner_tests {
+    int test_sharded_run();
+    int test_padded_sensitivities();
+    int test_malformed_inputs();
+}
+
+#endif /* scenario_runner_tests_hpp */
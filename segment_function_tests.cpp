@@ -131,4 +131,127 @@ int segment_function_tests::test_derivative(){
     int n_errors = static_cast<int>(not test_1_is_correct) + static_cast<int>(not test_2_is_correct);
     return n_errors;
 
-}
\ No newline at end of file
+}
+
+int segment_function_tests::test_evaluation(){
+    SegmentFunction test_segf = build_test_segment_function();
+    std::vector<double> points = {0, 0.5, 2};
+    torch::Tensor t = torch::tensor(points);
+    torch::Tensor values = test_segf(t);
+
+    bool is_correct = (values.size(0) == 3);
+    for (int i = 0; i < 3 && is_correct; ++i){
+        double t_i = points[i];
+        double target = std::exp(t_i) * (1 + t_i + t_i * t_i) + 1;
+        is_correct &= (std::abs(values[i].item<double>() - target) < 1e-12);
+        is_correct &= (std::abs(test_segf(t_i).item<double>() - target) < 1e-12);
+    }
+    std::string output_message = is_correct ? "Evaluation passed " : "Evaluation FAILED";
+    std::cout << output_message << std::endl;
+    if (not is_correct){
+        std::cout << "Received values: " << values << std::endl;
+    }
+    return static_cast<int>(not is_correct);
+}
+
+int segment_function_tests::test_shift(){
+    std::vector<double> exp_coefs = {-0.04, 0};
+    std::vector<double> p_coefs = {1, 0.1, -0.01};
+    std::vector<double> q_coefs = {0.5};
+    std::vector<TorchPolynomial> polynomials{TorchPolynomial(torch::tensor(p_coefs)), TorchPolynomial(torch::tensor(q_coefs))};
+    SegmentFunction absolute_segf(torch::tensor(exp_coefs), polynomials);
+
+    // segment [30, 40] stored on [0, 10], then re-anchored after the valuation date rolls forward one day
+    const double anchor = 30;
+    const double roll = 1.0 / 365;
+    SegmentFunction local_segf = absolute_segf.shift(anchor);
+    SegmentFunction rolled_segf = local_segf.shift(roll);
+
+    // composing a detached curve must not turn its coefficients back into grad-requiring leaves
+    SegmentFunction detached_local_segf = absolute_segf.detach().shift(anchor);
+    bool is_correct = not detached_local_segf.get_polynomials()[0].coefficients().requires_grad();
+    std::vector<double> local_points = {0, 2.5, 10 - roll};
+    for (int i = 0; i < local_points.size(); ++i){
+        double s = local_points[i];
+        double target = absolute_segf(anchor + s).item<double>();
+        is_correct &= (std::abs(local_segf(s).item<double>() - target) < 1e-9);
+        double rolled_target = absolute_segf(anchor + roll + s).item<double>();
+        is_correct &= (std::abs(rolled_segf(s).item<double>() - rolled_target) < 1e-9);
+    }
+    std::string output_message = is_correct ? "Shift passed " : "Shift FAILED";
+    std::cout << output_message << std::endl;
+    if (not is_correct){
+        std::cout << "Local function: " << std::endl;
+        local_segf.print();
+    }
+    return static_cast<int>(not is_correct);
+}
+
+int segment_function_tests::test_independent_equal_rates(){
+    // two independent rates which start out equal, as in a calibration initialised at 0
+    torch::Tensor f_rate = torch::zeros(1, torch::kFloat64).set_requires_grad(true);
+    torch::Tensor g_rate = torch::zeros(1, torch::kFloat64).set_requires_grad(true);
+    SegmentFunction f_segf(f_rate, std::vector<TorchPolynomial>{TorchPolynomial(1.0)});
+    SegmentFunction g_segf(g_rate, std::vector<TorchPolynomial>{TorchPolynomial(2.0)});
+    SegmentFunction sum_segf = f_segf + g_segf;
+
+    // d/dc e^{ct} P(t) = t e^{ct} P(t), so at c = 0 and t = 1.5 the gradients are 1.5 * 1 and 1.5 * 2
+    sum_segf(1.5).backward();
+    bool is_correct = (sum_segf.get_exp_coefs().size(0) == 2)
+        && f_rate.grad().defined() && g_rate.grad().defined()
+        && (std::abs(f_rate.grad().item<double>() - 1.5) < 1e-12)
+        && (std::abs(g_rate.grad().item<double>() - 3) < 1e-12);
+    std::string output_message = is_correct ? "Independent equal rates passed " : "Independent equal rates FAILED";
+    std::cout << output_message << std::endl;
+    if (not is_correct){
+        sum_segf.print();
+    }
+    return static_cast<int>(not is_correct);
+}
+
+int segment_function_tests::test_batched_evaluation(){
+    std::vector<double> exp_coefs = {-0.04, 0};
+    std::vector<double> p_coefs = {1, 0.1, -0.01};
+    std::vector<double> q_coefs = {0.5};
+    std::vector<TorchPolynomial> polynomials{TorchPolynomial(torch::tensor(p_coefs)), TorchPolynomial(torch::tensor(q_coefs))};
+    SegmentFunction absolute_segf(torch::tensor(exp_coefs), polynomials);
+    SegmentFunction local_segf = absolute_segf.shift(30);
+
+    // row 0 holds the segment in local coordinates, row 1 in absolute ones, both padded up to degree 3
+    const int n_coefs = 4;
+    std::vector<SegmentFunction> functions{local_segf.detach(), absolute_segf.detach()};
+    torch::Tensor batch_exp_coefs = torch::zeros({2, 2}, torch::kFloat64);
+    torch::Tensor batch_polynomial_coefs = torch::zeros({2, 2, n_coefs}, torch::kFloat64);
+    for (int s = 0; s < 2; ++s){
+        batch_exp_coefs[s].copy_(functions[s].get_exp_coefs());
+        for (int i = 0; i < 2; ++i){
+            torch::Tensor coefs = functions[s].get_polynomials()[i].coefficients();
+            batch_polynomial_coefs[s][i].narrow(0, 0, coefs.size(0)).copy_(coefs);
+        }
+    }
+    batch_polynomial_coefs.set_requires_grad(true);
+
+    std::vector<double> points = {0, 2.5, 10};
+    torch::Tensor t = torch::tensor(points);
+    torch::Tensor values = SegmentFunction::evaluate_batched(batch_exp_coefs, batch_polynomial_coefs, t);
+    bool is_correct = (values.size(0) == 2) && (values.size(1) == 3);
+    for (int k = 0; k < points.size() && is_correct; ++k){
+        is_correct &= (std::abs(values[0][k].item<double>() - absolute_segf(30 + points[k]).item<double>()) < 1e-10);
+        is_correct &= (std::abs(values[1][k].item<double>() - absolute_segf(points[k]).item<double>()) < 1e-12);
+    }
+
+    // the padding coefficient of degree 3 gets its own gradient, sum_k e^{c t_k} t_k^3
+    values[1].sum().backward();
+    double padding_gradient = 0;
+    for (int k = 0; k < points.size(); ++k){
+        padding_gradient += std::exp(-0.04 * points[k]) * std::pow(points[k], 3);
+    }
+    is_correct &= (std::abs(batch_polynomial_coefs.grad()[1][0][3].item<double>() - padding_gradient) < 1e-9);
+
+    std::string output_message = is_correct ? "Batched evaluation passed " : "Batched evaluation FAILED";
+    std::cout << output_message << std::endl;
+    if (not is_correct){
+        std::cout << "Received values: " << values << std::endl;
+    }
+    return static_cast<int>(not is_correct);
+}
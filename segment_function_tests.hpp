@@ -17,4 +17,8 @@ namespace segment_function_tests {
     int test_multiplication();
     int test_derivative();
     int test_antiderivative();
+    int test_evaluation();
+    int test_shift();
+    int test_independent_equal_rates();
+    int test_batched_evaluation();
 }
\ No newline at end of file
@@ -8,9 +8,10 @@
 #include <stdio.h>
 #include <torch/csrc/api/include/torch/all.h>
 #include "segment_functions.hpp"
+#include "precision_policy.hpp"
 
 SegmentFunction::SegmentFunction(torch::Tensor in_exp_coefs, std::vector<TorchPolynomial> in_polynomials):
-    exp_coefs(in_exp_coefs),
+    exp_coefs(precision_policy::cast(in_exp_coefs)),
     polynomials(in_polynomials){
     _align_by_exp_coef();
 }
@@ -20,15 +21,17 @@ SegmentFunction::SegmentFunction(
     std::vector<TorchPolynomial> in_polynomials
 ){
     int nb_polynomials = in_polynomials.size();
-    exp_coefs = torch::zeros(nb_polynomials);
+    exp_coefs = torch::zeros(nb_polynomials, precision_policy::options());
     polynomials = in_polynomials;
     _align_by_exp_coef();
 }
 
 SegmentFunction::SegmentFunction(TorchPolynomial in_polynomial):
+    exp_coefs(torch::zeros(1, precision_policy::options())),
     polynomials(std::vector<TorchPolynomial>{in_polynomial}){}
 
 SegmentFunction::SegmentFunction(double in_constant):
+    exp_coefs(torch::zeros(1, precision_policy::options())),
     polynomials(std::vector<TorchPolynomial>{TorchPolynomial(in_constant)}){}
 
 torch::Tensor SegmentFunction::get_exp_coefs() const {
@@ -81,7 +84,7 @@ SegmentFunction SegmentFunction::pow(const int power) const {
     }
     else if (power == 0){
         return SegmentFunction(
-            TorchPolynomial(torch::ones(1))
+            TorchPolynomial(torch::ones(1, precision_policy::options()))
         );
     }
     else {
@@ -110,16 +113,73 @@ SegmentFunction SegmentFunction::operator*(const double other) const {
     return this->operator*(SegmentFunction(other));
 }
 
+/**
+ * @brief Evaluates \f$ \sum_i e^{c_i t} P_i(t) \f$ elementwise, so t can hold a whole batch of evaluation points.
+ */
+torch::Tensor SegmentFunction::operator()(const torch::Tensor t) const {
+    const torch::Dtype eval_dtype = precision_policy::promote(precision_policy::cast(t), exp_coefs);
+    torch::Tensor cast_t = t.to(eval_dtype);
+    torch::Tensor result = torch::zeros_like(cast_t);
+    const int n_polynomials = polynomials.size();
+    for (int i = 0; i < n_polynomials; ++i){
+        result = result + torch::exp(exp_coefs[i].to(eval_dtype) * cast_t) * polynomials[i](cast_t);
+    }
+    return result;
+}
+
+/**
+ * @brief Evaluates S functions given as padded tensors, \f$ f_s(t) = \sum_i e^{c_{s,i} t} P_{s,i}(t) \f$, in one pass.
+ *
+ * in_exp_coefs is [S, T], in_polynomial_coefs is [S, T, degree + 1] with monomial coefficients padded with zeros,
+ * t holds K points and the result is [S, K]. Unlike building SegmentFunction objects, no trailing zero is dropped and
+ * no term is reordered, so every input coefficient keeps its own gradient. Polynomials go through Horner's scheme;
+ * keep t local to the segment for well conditioned coefficients, i.e. pass the coefficients of shift(t_0) and t - t_0.
+ */
+torch::Tensor SegmentFunction::evaluate_batched(const torch::Tensor in_exp_coefs, const torch::Tensor in_polynomial_coefs, const torch::Tensor t){
+    TORCH_CHECK(
+        in_exp_coefs.dim() == 2 && in_polynomial_coefs.dim() == 3
+            && in_polynomial_coefs.size(0) == in_exp_coefs.size(0) && in_polynomial_coefs.size(1) == in_exp_coefs.size(1)
+            && in_polynomial_coefs.size(2) > 0,
+        "SegmentFunction::evaluate_batched: expected exp coefficients [S, T] and polynomial coefficients [S, T, degree + 1], got ",
+        in_exp_coefs.sizes(), " and ", in_polynomial_coefs.sizes()
+    );
+    const torch::Dtype eval_dtype = torch::promote_types(
+        precision_policy::promote(precision_policy::cast(t), in_exp_coefs),
+        in_polynomial_coefs.scalar_type()
+    );
+    torch::Tensor cast_t = t.reshape(-1).to(eval_dtype);
+    torch::Tensor coefs = in_polynomial_coefs.to(eval_dtype);
+    const int64_t n_coefs = coefs.size(2);
+
+    // [S, T, K]
+    torch::Tensor polynomial_values = coefs.select(2, n_coefs - 1).unsqueeze(-1).expand({-1, -1, cast_t.size(0)});
+    for (int64_t j = n_coefs - 2; j >= 0; --j){
+        polynomial_values = polynomial_values * cast_t + coefs.select(2, j).unsqueeze(-1);
+    }
+    torch::Tensor exp_values = torch::exp(in_exp_coefs.to(eval_dtype).unsqueeze(-1) * cast_t);
+    return (exp_values * polynomial_values).sum(1);
+}
+
+torch::Tensor SegmentFunction::operator()(const double t) const {
+    torch::Tensor torch_t = torch::scalar_tensor(t, exp_coefs.options());
+    return SegmentFunction::operator()(torch_t);
+}
+
+/**
+ * @brief Equality as functions: terms sharing an exp coefficient are summed before comparing.
+ */
 bool SegmentFunction::operator==(const SegmentFunction& other) const {
-    if (exp_coefs.size(0) != other.exp_coefs.size(0)){
+    std::pair<std::vector<double>, std::vector<TorchPolynomial>> this_terms = _merged_terms();
+    std::pair<std::vector<double>, std::vector<TorchPolynomial>> other_terms = other._merged_terms();
+    if (this_terms.first.size() != other_terms.first.size()){
         return false;
     }
-    for (int i = 0; i < exp_coefs.size(0); ++i){
-        // We assume that the exp_coefs for each SegmentFunction are already sorted
-        if (exp_coefs[i].item<double>() != other.exp_coefs[i].item<double>()){
+    for (int i = 0; i < this_terms.first.size(); ++i){
+        // both sides are sorted by exp coefficient
+        if (this_terms.first[i] != other_terms.first[i]){
             return false;
         }
-        if (polynomials[i] != other.polynomials[i]){
+        if (this_terms.second[i] != other_terms.second[i]){
             return false;
         }
     }
@@ -130,72 +190,57 @@ bool SegmentFunction::operator!=(const SegmentFunction& other) const {
     return not operator==(other);
 }
 
+/**
+ * @brief Sorts the terms by exp coefficient, keeping every term.
+ *
+ * The order is decided on the host, but exp_coefs is permuted by tensor indexing so that every coefficient keeps
+ * its own autograd link (and replays correctly from a ReplayTape). Terms with equal coefficients are not merged:
+ * they may come from independent parameters which only happen to be equal, e.g. rates all starting at 0 in a
+ * calibration, and each must keep its own gradient. Merging by value is left to operator== and print().
+ */
 void SegmentFunction::_align_by_exp_coef(){
-    std::tuple<at::Tensor, at::Tensor, at::Tensor> values_invindex_counts = at::_unique2(exp_coefs, false, false, true);
-    at::Tensor values = std::get<0>(values_invindex_counts);
-    at::Tensor inverse_index = std::get<1>(values_invindex_counts);
-    at::Tensor counts = std::get<2>(values_invindex_counts);
-    std::tuple<at::Tensor, at::Tensor> sorted_argsort = torch::sort(values);
-
-    values = std::get<0>(sorted_argsort);
-    at::Tensor sorted_index = std::get<1>(sorted_argsort);
-    counts = counts.index({sorted_index});
+    at::Tensor sorted_index = std::get<1>(torch::sort(exp_coefs.detach(), /*stable=*/true, 0, false));
     const int num_coefs = exp_coefs.size(0);
-    const int num_unique_coefs = values.size(0);
-    if (num_unique_coefs == num_coefs) {
-        // if we do not need to factor out any polynomials, we make sure the polynomials are sorted by exp coef
 
-        // sorted_index is NOT the order for exp_coefs, but for values... 
-        // we need to make sure that gradients will be properly passed through...
-
-        exp_coefs = exp_coefs.index({inverse_index});
-        std::vector<TorchPolynomial> new_polynomials;
-        for (int i = 0; i < polynomials.size(); ++i){
-            new_polynomials.push_back(polynomials[inverse_index[i].item<int>()]);
-        }
-        polynomials = new_polynomials;
-        return;
+    std::vector<TorchPolynomial> new_polynomials;
+    for (int k = 0; k < num_coefs; ++k){
+        new_polynomials.push_back(polynomials[sorted_index[k].item<int64_t>()]);
     }
-    else {
-        std::vector<int> idx_to_keep;
-        for (int k = 0; k < num_unique_coefs; ++k) {
-            if (counts[k].item<double>() > 1){
-                std::vector<int> is_value_idx;
-                double value_to_match = values[k].item<double>();
-                for (int i = 0; i < num_coefs; ++i){
-                    if (exp_coefs[i].item<double>() == value_to_match){
-                        is_value_idx.push_back(i);
-                    }
-                }
-                idx_to_keep.push_back(is_value_idx[0]);
-                int num_duplicates = is_value_idx.size();
-                for (int i = 1; i < num_duplicates; ++i){
-                    int idx_to_drop = is_value_idx[i];
-                    TorchPolynomial old_polynomial = polynomials[is_value_idx[0]].clone();
-                    polynomials[is_value_idx[0]] = old_polynomial + polynomials[idx_to_drop];
-                }
-            }
+    exp_coefs = exp_coefs.index({sorted_index});
+    polynomials = new_polynomials;
+}
+
+/**
+ * @brief The terms with their polynomials summed over equal exp coefficients, as host values.
+ *
+ * Only used to compare and display functions, the stored terms are never merged.
+ */
+std::pair<std::vector<double>, std::vector<TorchPolynomial>> SegmentFunction::_merged_terms() const {
+    std::vector<double> merged_exp_coefs;
+    std::vector<TorchPolynomial> merged_polynomials;
+    for (int i = 0; i < polynomials.size(); ++i){
+        const double value = exp_coefs[i].item<double>();
+        if (i > 0 && value == merged_exp_coefs.back()){
+            merged_polynomials.back() = merged_polynomials.back() + polynomials[i];
         }
-        torch::Tensor new_exp_coefs = torch::zeros(idx_to_keep.size());
-        std::vector<TorchPolynomial> new_polynomials;
-        for (int k = 0; k < num_unique_coefs; ++k){
-            new_exp_coefs[k] += exp_coefs[idx_to_keep[k]].item<double>();
-            new_polynomials.push_back(polynomials[idx_to_keep[k]]);
+        else {
+            merged_exp_coefs.push_back(value);
+            merged_polynomials.push_back(polynomials[i]);
         }
-        exp_coefs = new_exp_coefs;
-        polynomials = new_polynomials;
     }
+    return std::make_pair(merged_exp_coefs, merged_polynomials);
 }
 
 SegmentFunction SegmentFunction::derivative() const {
-    torch::Tensor new_exp_coefs = torch::stack({exp_coefs.clone(), exp_coefs.clone()});
+    torch::Tensor new_exp_coefs = torch::cat({exp_coefs, exp_coefs});
     const int n_polynomials = exp_coefs.size(0);
     std::vector<TorchPolynomial> new_polynomials;
     for (int i = 0; i < n_polynomials; ++i) {
         new_polynomials.push_back(polynomials[i].derivative());
     }
     for (int i = 0; i < n_polynomials; ++i) {
-        new_polynomials.push_back(polynomials[i] * exp_coefs[i].item<double>());
+        // kept as a tensor so that the exp coefficient stays differentiable and is not frozen into a recorded tape
+        new_polynomials.push_back(polynomials[i] * TorchPolynomial(exp_coefs[i].reshape(1), false));
     }
     return SegmentFunction(
         new_exp_coefs,
@@ -203,24 +248,35 @@ SegmentFunction SegmentFunction::derivative() const {
     );
 }
 
-TorchPolynomial SegmentFunction::_single_antiderivative(const TorchPolynomial& in_polynomial, double in_exp_coef) const {
-    if (in_exp_coef == 0){
+/**
+ * @brief Antiderivative of \f$ e^{cx} P(x) \f$, as the polynomial Q with \f$ (e^{cx} Q)' = e^{cx} P \f$.
+ *
+ * The exp coefficient is taken as a tensor so that the \f$ 1/c \f$ factors stay differentiable; only the c == 0
+ * branch is decided on the host.
+ */
+TorchPolynomial SegmentFunction::_single_antiderivative(const TorchPolynomial& in_polynomial, const torch::Tensor in_exp_coef) const {
+    if (in_exp_coef.item<double>() == 0){
         return in_polynomial.antiderivative();
     }
-    else if (in_polynomial.degree() > 0) {
-        TorchPolynomial derived_polynomial = in_polynomial.derivative() * (1 / in_exp_coef);
-        return in_polynomial * (1 / in_exp_coef) - _single_antiderivative(derived_polynomial, in_exp_coef);
+    TorchPolynomial inverse_exp_coef(1 / in_exp_coef.reshape(1), false);
+    if (in_polynomial.degree() > 0) {
+        TorchPolynomial derived_polynomial = in_polynomial.derivative() * inverse_exp_coef;
+        return in_polynomial * inverse_exp_coef - _single_antiderivative(derived_polynomial, in_exp_coef);
     }
     else {
-        return in_polynomial * (1 / in_exp_coef);
+        return in_polynomial * inverse_exp_coef;
     }
 }
 
+/**
+ * @brief Term by term antiderivative. Terms with \f$ c = 0 \f$ vanish at 0, unlike ChebyshevSegmentFunction::antiderivative()
+ * which fixes their constant at the lower end of its segment; terms with \f$ c \ne 0 \f$ carry no constant.
+ */
 SegmentFunction SegmentFunction::antiderivative() const {
     std::vector<TorchPolynomial> new_polynomials;
     const int n_polynomials = polynomials.size();
     for (int i = 0; i < n_polynomials; ++i) {
-        new_polynomials.push_back(_single_antiderivative(polynomials[i], exp_coefs[i].item<double>()));
+        new_polynomials.push_back(_single_antiderivative(polynomials[i], exp_coefs[i]));
     }
     return SegmentFunction(
         exp_coefs.clone(),
@@ -228,6 +284,39 @@ SegmentFunction SegmentFunction::antiderivative() const {
     );
 }
 
+/**
+ * @brief Computes \f$ g(t) = f(at + b) \f$
+ *
+ * Each term \f$ e^{c(at + b)} P(at + b) \f$ becomes \f$ e^{(ca) t} \left( e^{cb} P(at + b) \right) \f$: the shifted part of
+ * the exponent factors out as a constant multiplier of the composed polynomial.
+ */
+SegmentFunction SegmentFunction::compose_affine(const double a, const double b) const {
+    std::vector<TorchPolynomial> new_polynomials;
+    const int n_polynomials = polynomials.size();
+    for (int i = 0; i < n_polynomials; ++i){
+        torch::Tensor constant_factor = torch::exp(exp_coefs[i] * b);
+        TorchPolynomial composed_polynomial = polynomials[i].compose_affine(a, b);
+        new_polynomials.push_back(TorchPolynomial(
+            composed_polynomial.coefficients() * constant_factor,
+            composed_polynomial.get_requires_grad()
+        ));
+    }
+    return SegmentFunction(
+        exp_coefs * a,
+        new_polynomials
+    );
+}
+
+/**
+ * @brief \f$ g(t) = f(t + offset) \f$
+ *
+ * A segment covering \f$ [t_0, t_0 + h] \f$ is stored in local coordinates on \f$ [0, h] \f$ as shift(t_0), and
+ * re-anchored after the valuation date rolls forward by d with shift(d), without recalibrating.
+ */
+SegmentFunction SegmentFunction::shift(const double offset) const {
+    return compose_affine(1, offset);
+}
+
 SegmentFunction SegmentFunction::get_exponential() const {
     assert(degree() <= 1);
     bool exp_coefs_are_zero = true;
@@ -236,7 +325,7 @@ SegmentFunction SegmentFunction::get_exponential() const {
     }
     assert(exp_coefs_are_zero);
     std::vector<TorchPolynomial> constants;
-    torch::Tensor new_exp_coefs = torch::zeros(exp_coefs.size(0));
+    torch::Tensor new_exp_coefs = torch::zeros(exp_coefs.size(0), exp_coefs.options());
     for (int i = 0; i < polynomials.size(); ++i) {
         TorchPolynomial polynomials_i = polynomials[i];
         torch::Tensor exp_coef_i = polynomials_i[0];
@@ -252,6 +341,17 @@ SegmentFunction SegmentFunction::get_exponential() const {
     );
 }
 
+SegmentFunction SegmentFunction::detach() const {
+    std::vector<TorchPolynomial> new_polynomials;
+    for (int i = 0; i < polynomials.size(); ++i){
+        new_polynomials.push_back(polynomials[i].detach());
+    }
+    return SegmentFunction(
+        exp_coefs.detach().clone(),
+        new_polynomials
+    );
+}
+
 size_t SegmentFunction::degree() const {
     size_t greatest_degree = 0;
     for (int i = 0; i < polynomials.size(); ++i){
@@ -263,9 +363,10 @@ size_t SegmentFunction::degree() const {
 }
 
 void SegmentFunction::print() const {
-    for (int i = 0; i < polynomials.size(); ++i){
-            std::cout << "Exp " << exp_coefs[i].item<double>() << " * ";
-            TorchPolynomial polynomial_i = polynomials[i];
+    std::pair<std::vector<double>, std::vector<TorchPolynomial>> terms = _merged_terms();
+    for (int i = 0; i < terms.second.size(); ++i){
+            std::cout << "Exp " << terms.first[i] << " * ";
+            TorchPolynomial polynomial_i = terms.second[i];
             for (int j = 0; j < polynomial_i.coefficients().size(0); ++j){
                 std::cout << polynomial_i.coefficients()[j].item<double>() << " ";
             }
@@ -22,6 +22,8 @@ class SegmentFunction{
         SegmentFunction(TorchPolynomial in_polynomial);
         SegmentFunction(double in_constant);
 
+        static torch::Tensor evaluate_batched(const torch::Tensor in_exp_coefs, const torch::Tensor in_polynomial_coefs, const torch::Tensor t);
+
         torch::Tensor get_exp_coefs() const;
         std::vector<TorchPolynomial> get_polynomials() const;
 
@@ -31,6 +33,9 @@ class SegmentFunction{
         SegmentFunction operator-(const double other) const;
         SegmentFunction operator*(const SegmentFunction& other) const;
         SegmentFunction operator*(const double other) const;
+        torch::Tensor operator()(const torch::Tensor t) const;
+        torch::Tensor operator()(const double t) const;
+
         bool operator==(const SegmentFunction& other) const;
         bool operator!=(const SegmentFunction& other) const;
         
@@ -38,7 +43,10 @@ class SegmentFunction{
 
         SegmentFunction derivative() const;
         SegmentFunction antiderivative() const;
+        SegmentFunction compose_affine(const double a, const double b) const;
+        SegmentFunction shift(const double offset) const;
         SegmentFunction get_exponential() const;
+        SegmentFunction detach() const;
 
         size_t degree() const;
         void print() const;
@@ -48,7 +56,8 @@ class SegmentFunction{
         std::vector<TorchPolynomial> polynomials;
 
         void _align_by_exp_coef();
-        TorchPolynomial _single_antiderivative(const TorchPolynomial& in_polynomial, double in_exp_coef) const;
+        std::pair<std::vector<double>, std::vector<TorchPolynomial>> _merged_terms() const;
+        TorchPolynomial _single_antiderivative(const TorchPolynomial& in_polynomial, const torch::Tensor in_exp_coef) const;
 
 };
 
@@ -0,0 +1,84 @@
+//
+//  shared_memory.cpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include "shared_memory.hpp"
+
+SharedMemoryBlock::SharedMemoryBlock(const std::string& in_name, size_t in_size):
+    segment_name(in_name),
+    // mmap rejects empty mappings, an empty tensor still gets one byte
+    segment_size(std::max(in_size, static_cast<size_t>(1))),
+    address(nullptr),
+    owner_pid(getpid()){
+        int descriptor = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (descriptor < 0){
+            throw std::runtime_error("shm_open failed for " + segment_name + ": " + std::strerror(errno));
+        }
+        if (ftruncate(descriptor, segment_size) != 0){
+            int error = errno;
+            close(descriptor);
+            shm_unlink(segment_name.c_str());
+            throw std::runtime_error("ftruncate failed for " + segment_name + ": " + std::strerror(error));
+        }
+        address = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        int error = errno;
+        // the mapping keeps the segment alive, the descriptor is no longer needed
+        close(descriptor);
+        if (address == MAP_FAILED){
+            address = nullptr;
+            shm_unlink(segment_name.c_str());
+            throw std::runtime_error("mmap failed for " + segment_name + ": " + std::strerror(error));
+        }
+}
+
+SharedMemoryBlock::~SharedMemoryBlock(){
+    if (address != nullptr){
+        munmap(address, segment_size);
+    }
+    if (getpid() == owner_pid){
+        shm_unlink(segment_name.c_str());
+    }
+}
+
+std::shared_ptr<SharedMemoryBlock> SharedMemoryBlock::for_tensor(const std::string& in_name, torch::IntArrayRef sizes, torch::Dtype dtype){
+    int64_t n_elements = 1;
+    for (int64_t size : sizes){
+        n_elements *= size;
+    }
+    return std::make_shared<SharedMemoryBlock>(in_name, n_elements * c10::elementSize(dtype));
+}
+
+void* SharedMemoryBlock::data() const {
+    return address;
+}
+
+size_t SharedMemoryBlock::size() const {
+    return segment_size;
+}
+
+std::string SharedMemoryBlock::name() const {
+    return segment_name;
+}
+
+/**
+ * @brief Non-owning view of the segment, only valid while this block is alive.
+ */
+torch::Tensor SharedMemoryBlock::as_tensor(torch::IntArrayRef sizes, torch::Dtype dtype) const {
+    return torch::from_blob(address, sizes, torch::TensorOptions().dtype(dtype));
+}
+
+/**
+ * @brief View of the segment which keeps the block alive for as long as the tensor's storage is.
+ */
+torch::Tensor SharedMemoryBlock::as_owning_tensor(std::shared_ptr<SharedMemoryBlock> block, torch::IntArrayRef sizes, torch::Dtype dtype){
+    return torch::from_blob(block->data(), sizes, [block](void*){}, torch::TensorOptions().dtype(dtype));
+}
@@ -0,0 +1,48 @@
+//
+//  shared_memory.hpp
+//  quick-potatoes
+//
+//  Created by Aion Feehan on 10/19/26.
+//
+
+#ifndef shared_memory_hpp
+#define shared_memory_hpp
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <torch/script.h>
+
+/**
+ * @brief Named POSIX shared memory segment, mapped read-write in the creating process.
+ *
+ * Processes forked after construction inherit the mapping, so tensors viewing the segment through as_tensor() are
+ * seen by every worker without copying. The creating process unmaps and unlinks the segment on destruction; forked
+ * children must leave with _exit() so that they do not unlink it too.
+ */
+class SharedMemoryBlock {
+
+    public:
+        SharedMemoryBlock(const std::string& in_name, size_t in_size);
+        ~SharedMemoryBlock();
+
+        SharedMemoryBlock(const SharedMemoryBlock&) = delete;
+        SharedMemoryBlock& operator=(const SharedMemoryBlock&) = delete;
+
+        static std::shared_ptr<SharedMemoryBlock> for_tensor(const std::string& in_name, torch::IntArrayRef sizes, torch::Dtype dtype);
+
+        void* data() const;
+        size_t size() const;
+        std::string name() const;
+
+        torch::Tensor as_tensor(torch::IntArrayRef sizes, torch::Dtype dtype) const;
+        static torch::Tensor as_owning_tensor(std::shared_ptr<SharedMemoryBlock> block, torch::IntArrayRef sizes, torch::Dtype dtype);
+
+    private:
+        std::string segment_name;
+        size_t segment_size;
+        void* address;
+        pid_t owner_pid;
+};
+
+#endif /* shared_memory_hpp */
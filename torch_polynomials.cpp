@@ -8,23 +8,24 @@
 #include <ATen/ATen.h>
 #include <torch/csrc/api/include/torch/nn/functional.h>
 #include "torch_polynomials.hpp"
+#include "precision_policy.hpp"
 
 TorchPolynomial::TorchPolynomial(torch::Tensor in_coefficients, bool in_requires_grad){
-    coefficient_tensor = clean_trailing_zeros(in_coefficients);
+    coefficient_tensor = clean_trailing_zeros(precision_policy::cast(in_coefficients));
     requires_grad = in_requires_grad;
     coefficient_tensor.set_requires_grad(requires_grad);
 }
 
 TorchPolynomial::TorchPolynomial(double in_coefficient, bool in_requires_grad): 
-    coefficient_tensor(clean_trailing_zeros(in_coefficient * torch::ones(1))), 
+    coefficient_tensor(clean_trailing_zeros(in_coefficient * torch::ones(1, precision_policy::options()))), 
     requires_grad(in_requires_grad){
         coefficient_tensor.set_requires_grad(requires_grad);
 }
 
-static torch::Tensor clean_trailing_zeros(torch::Tensor in_tensor){
+torch::Tensor TorchPolynomial::clean_trailing_zeros(torch::Tensor in_tensor){
     int n_zeros = 0;
     int tensor_size = in_tensor.size(0);
-    for (int i = tensor_size; i > 0; --i){
+    for (int i = tensor_size - 1; i > 0; --i){
         if (in_tensor[i].item<double>() == 0){
             n_zeros++;
         }
@@ -45,6 +46,10 @@ size_t TorchPolynomial::degree() const {
     return coefficient_tensor.size(0) - 1;
 }
 
+bool TorchPolynomial::get_requires_grad() const {
+    return requires_grad;
+}
+
 namespace F = torch::nn::functional;
 
 TorchPolynomial TorchPolynomial::operator+(const TorchPolynomial& other) const {
@@ -67,7 +72,10 @@ TorchPolynomial TorchPolynomial::operator*(const TorchPolynomial& other) const {
     const int other_degree = other.degree();
     const int new_degree = this_degree + other_degree;
     bool new_requires_grad = requires_grad || other.requires_grad;
-    torch::Tensor new_coefficients = torch::zeros({new_degree + 1, new_degree + 1});
+    torch::Tensor new_coefficients = torch::zeros(
+        {new_degree + 1, new_degree + 1},
+        torch::TensorOptions().dtype(precision_policy::promote(coefficient_tensor, other.coefficient_tensor))
+    );
 
     for (int i = 0; i <= this_degree; ++i){
         for (int j = 0; j <= other_degree; ++j){
@@ -82,7 +90,7 @@ TorchPolynomial TorchPolynomial::operator*(const double other) const {
 }
 
 TorchPolynomial TorchPolynomial::operator-(const TorchPolynomial& other) const {
-    TorchPolynomial minus_one = TorchPolynomial(torch::tensor((double) -1));
+    TorchPolynomial minus_one = TorchPolynomial(static_cast<double>(-1));
     return operator+(minus_one.operator*(other));
 }
 
@@ -125,7 +133,7 @@ bool TorchPolynomial::operator!=(const TorchPolynomial& other) const {
 TorchPolynomial TorchPolynomial::derivative() const {
     std::vector<torch::Tensor> new_coefficients;
     if (degree() == 0){
-        return TorchPolynomial(torch::zeros(1));
+        return TorchPolynomial(torch::zeros(1, coefficient_tensor.options()));
     }
     for (int k = 1; k <= degree(); ++k){
         new_coefficients.push_back(k * coefficient_tensor[k]);
@@ -133,27 +141,70 @@ TorchPolynomial TorchPolynomial::derivative() const {
     return TorchPolynomial(torch::stack(torch::TensorList(new_coefficients)), requires_grad);
 }
 
+/**
+ * @brief Antiderivative vanishing at 0. ChebyshevPolynomial::antiderivative() vanishes at its lower bound instead.
+ */
 TorchPolynomial TorchPolynomial::antiderivative() const {
-    std::vector<torch::Tensor> new_coefficients({torch::zeros(1)});
-    for (int k = 0; k < degree(); ++k){
-        new_coefficients.push_back(coefficient_tensor[k] / (float) k + 1);
+    std::vector<torch::Tensor> new_coefficients({torch::zeros({}, coefficient_tensor.options())});
+    for (int k = 0; k <= degree(); ++k){
+        new_coefficients.push_back(coefficient_tensor[k] / static_cast<double>(k + 1));
     }
     return TorchPolynomial(torch::stack(torch::TensorList(new_coefficients)), requires_grad);
 }
 
+/**
+ * 
+ * \fn TorchPolynomial TorchPolynomial::compose_affine(const double a, const double b)
+ * @brief Computes \f$ g(X) = f(aX + b) \f$
+ * 
+ *  \f$ g(X) = \sum_{j=0}^n \left( \sum_{k=j}^n \binom{k}{j} a^j b^{k-j} a_k \right) X^j \f$, applied as a single
+ *  matrix product on the coefficients so that gradients flow back to them.
+ * 
+ * @return TorchPolynomial 
+ */
+TorchPolynomial TorchPolynomial::compose_affine(const double a, const double b) const {
+    const int n = degree();
+    std::vector<double> transform((n + 1) * (n + 1), 0);
+    // binomial[j] holds C(k, j) for the current k, updated row by row as in Pascal's triangle
+    std::vector<double> binomial(n + 1, 0);
+    binomial[0] = 1;
+    for (int k = 0; k <= n; ++k){
+        for (int j = k; j > 0; --j){
+            binomial[j] += binomial[j - 1];
+        }
+        double a_power = 1;
+        for (int j = 0; j <= k; ++j){
+            transform[j * (n + 1) + k] = binomial[j] * a_power * std::pow(b, k - j);
+            a_power *= a;
+        }
+    }
+    torch::Tensor transform_tensor = torch::tensor(transform, coefficient_tensor.options()).reshape({n + 1, n + 1});
+    return TorchPolynomial(torch::matmul(transform_tensor, coefficient_tensor), requires_grad);
+}
+
+/**
+ * @brief \f$ g(X) = f(X + offset) \f$, e.g. to move a segment to local coordinates or re-anchor it on a new valuation date.
+ */
+TorchPolynomial TorchPolynomial::shift(const double offset) const {
+    return compose_affine(1, offset);
+}
+
 torch::Tensor TorchPolynomial::operator()(const double t) const {
-    torch::Tensor torch_t = torch::tensor(t);
+    torch::Tensor torch_t = torch::scalar_tensor(t, coefficient_tensor.options());
     return TorchPolynomial::operator()(torch_t);
 }
 
 torch::Tensor TorchPolynomial::operator()(const torch::Tensor t) const {
     const size_t this_degree = degree();
+    const torch::Dtype eval_dtype = precision_policy::promote(precision_policy::cast(t), coefficient_tensor);
+    torch::Tensor cast_t = t.to(eval_dtype);
     std::vector<torch::Tensor> powers;
     for (int k = 0; k <= this_degree; ++k){
-        powers.push_back(t.pow(k));
+        powers.push_back(cast_t.pow(k));
     }
-    torch::Tensor stacked_powers = torch::stack(powers);
-    return torch::dot(stacked_powers, coefficient_tensor);
+    // powers are stacked along the last dimension so that a batch of evaluation points maps to a batch of values
+    torch::Tensor stacked_powers = torch::stack(powers, -1);
+    return torch::matmul(stacked_powers, coefficient_tensor.to(eval_dtype));
 }
 
 TorchPolynomial TorchPolynomial::clone() const {
@@ -161,6 +212,16 @@ TorchPolynomial TorchPolynomial::clone() const {
     return TorchPolynomial(cloned_values, requires_grad);
 }
 
+/**
+ * @brief Deep copy of the coefficients with no autograd history and requires_grad off.
+ *
+ * The copy shares no storage with this polynomial, so later in-place updates of either side are not seen by the other.
+ */
+TorchPolynomial TorchPolynomial::detach() const {
+    torch::Tensor detached_values = coefficient_tensor.detach().clone();
+    return TorchPolynomial(detached_values, false);
+}
+
 torch::Tensor TorchPolynomial::operator[](const int index) const {
     return coefficient_tensor[index];
 }
\ No newline at end of file
@@ -42,6 +42,7 @@ class TorchPolynomial{
 
         torch::Tensor coefficients() const;
         size_t degree() const;
+        bool get_requires_grad() const;
 
         /**
          *  Some nice documentation here
@@ -50,7 +51,10 @@ class TorchPolynomial{
          */
         TorchPolynomial derivative() const;
         TorchPolynomial antiderivative() const;
+        TorchPolynomial compose_affine(const double a, const double b) const;
+        TorchPolynomial shift(const double offset) const;
         TorchPolynomial clone() const;
+        TorchPolynomial detach() const;
 
     private:
         torch::Tensor coefficient_tensor;
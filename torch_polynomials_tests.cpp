@@ -11,6 +11,7 @@
 #include <string>
 #include "torch_polynomials.hpp"
 #include "torch_polynomials_tests.hpp"
+#include "precision_policy.hpp"
 
 int torch_polynomials_tests::test_degree(){
     int degree = 2;
@@ -41,8 +42,9 @@ int torch_polynomials_tests::test_addition(){
 }
 
 int torch_polynomials_tests::test_multiplication(){
-    torch::Tensor a_tensor = torch::ones(2);
-    torch::Tensor b_tensor = torch::ones(2);
+    // float64 so that the constructor keeps a_tensor itself in the graph instead of a cast copy
+    torch::Tensor a_tensor = torch::ones(2, torch::kFloat64).set_requires_grad(true);
+    torch::Tensor b_tensor = torch::ones(2, torch::kFloat64);
     TorchPolynomial a_polynomial = TorchPolynomial(a_tensor);
     TorchPolynomial b_polynomial = TorchPolynomial(b_tensor);
 
@@ -54,10 +56,82 @@ int torch_polynomials_tests::test_multiplication(){
     std::cout << output_message << "\n";
     int num_errors = (int) not is_correct;
 
+    // sum of the coefficients of (a_0 + a_1 X)(b_0 + b_1 X) is (a_0 + a_1)(b_0 + b_1), so d/da_k = b_0 + b_1 = 2
     torch::Tensor result_tensor = result_polynomial.coefficients();
     torch::sum(result_tensor).backward();
     torch::Tensor a_grad = a_tensor.grad();
+    bool grad_is_correct = a_grad.defined() && torch::allclose(a_grad, 2 * torch::ones(2, torch::kFloat64));
+    output_message = grad_is_correct ? "Multiplication grad passed" : "Multiplication grad FAILED";
+    std::cout << output_message << "\n";
+    num_errors += (int) not grad_is_correct;
+    return num_errors;
+}
+
+int torch_polynomials_tests::test_precision(){
+    int num_errors = 0;
+
+    TorchPolynomial default_polynomial = TorchPolynomial(1.0);
+    bool default_is_correct = (default_polynomial.coefficients().scalar_type() == precision_policy::dtype());
+    std::string output_message = default_is_correct ? "Default precision passed" : "Default precision FAILED";
+    std::cout << output_message << "\n";
+    num_errors += (int) not default_is_correct;
+
+    TorchPolynomial single_polynomial = TorchPolynomial(torch::ones(2, torch::kFloat32));
+    bool floating_is_correct = (single_polynomial.coefficients().scalar_type() == precision_policy::dtype());
+    output_message = floating_is_correct ? "Floating input cast passed" : "Floating input cast FAILED";
+    std::cout << output_message << "\n";
+    num_errors += (int) not floating_is_correct;
+
+    std::vector<int64_t> i_coefs = {1, 2};
+    TorchPolynomial integral_polynomial = TorchPolynomial(torch::tensor(i_coefs));
+    bool integral_is_correct = (integral_polynomial.coefficients().scalar_type() == precision_policy::dtype());
+    output_message = integral_is_correct ? "Integral input cast passed" : "Integral input cast FAILED";
+    std::cout << output_message << "\n";
+    num_errors += (int) not integral_is_correct;
+
+    TorchPolynomial d_polynomial = TorchPolynomial(torch::ones(2, torch::kFloat64));
+    precision_policy::PrecisionGuard guard(precision_policy::Precision::Float32);
+    TorchPolynomial f_polynomial = TorchPolynomial(torch::ones(2, torch::kFloat32));
+    TorchPolynomial f_constant = TorchPolynomial(2.0);
+    bool guard_is_correct = (f_polynomial.coefficients().scalar_type() == torch::kFloat32)
+        && (f_constant.coefficients().scalar_type() == torch::kFloat32)
+        && (f_polynomial(0.5).scalar_type() == torch::kFloat32)
+        && ((f_polynomial * f_constant).coefficients().scalar_type() == torch::kFloat32);
+    output_message = guard_is_correct ? "Float32 guard passed" : "Float32 guard FAILED";
+    std::cout << output_message << "\n";
+    num_errors += (int) not guard_is_correct;
+
+    // float64 objects and inputs keep their precision under the guard, mixed results take the wider dtype
+    TorchPolynomial mixed_polynomial = f_polynomial * d_polynomial;
+    bool promotion_is_correct = (d_polynomial(0.5).scalar_type() == torch::kFloat64)
+        && (TorchPolynomial(torch::ones(2, torch::kFloat64)).coefficients().scalar_type() == torch::kFloat64)
+        && (mixed_polynomial.coefficients().scalar_type() == torch::kFloat64)
+        && ((d_polynomial * 2.0).coefficients().scalar_type() == torch::kFloat64)
+        && (d_polynomial.shift(1).coefficients().scalar_type() == torch::kFloat64)
+        && (d_polynomial.detach().coefficients().scalar_type() == torch::kFloat64);
+    output_message = promotion_is_correct ? "Mixed precision promotion passed" : "Mixed precision promotion FAILED";
+    std::cout << output_message << "\n";
+    num_errors += (int) not promotion_is_correct;
 
-    std::cout << "Multiplication grad: " << a_grad[0] << "\n";
     return num_errors;
+}
+
+int torch_polynomials_tests::test_compose_affine(){
+    std::vector<double> coefs = {1, -2, 0.5, 0.25};
+    TorchPolynomial polynomial = TorchPolynomial(torch::tensor(coefs));
+    TorchPolynomial composed = polynomial.compose_affine(-0.5, 3);
+
+    std::vector<double> points = {-2, 0, 1.5, 4};
+    bool is_correct = true;
+    for (int i = 0; i < points.size(); ++i){
+        double target = polynomial(-0.5 * points[i] + 3).item<double>();
+        is_correct &= (std::abs(composed(points[i]).item<double>() - target) < 1e-10);
+    }
+    TorchPolynomial round_trip = polynomial.shift(35).shift(-35);
+    for (int k = 0; k <= polynomial.degree(); ++k){
+        is_correct &= (std::abs(round_trip[k].item<double>() - coefs[k]) < 1e-6);
+    }
+    std::string output_message = is_correct ? "Affine composition passed" : "Affine composition FAILED";
+    std::cout << output_message << "\n";
+    return (int) not is_correct;
 }
\ No newline at end of file
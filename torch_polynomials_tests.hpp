@@ -15,6 +15,8 @@ namespace torch_polynomials_tests {
     int test_degree();
     int test_addition();
     int test_multiplication();
+    int test_precision();
+    int test_compose_affine();
 }
 
 